@@ -0,0 +1,320 @@
+#include <malloc.h>
+#include <sys/resource.h>
+
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include "OnnxBuilder.h"
+#include "Simulator.h"
+#include "helper/CommandLineParser.h"
+
+/*
+ * Simulator speed benchmark. Synthetic GEMM, Conv and Attention models of
+ * increasing size are built in memory and simulated under fixed hardware
+ * configs; each case reports host seconds, simulated core cycles per host
+ * second and the peak resident set size of the run. Results can be compared
+ * against a CSV of an earlier run to catch slowdowns of the simulator itself.
+ */
+
+struct BenchmarkCase {
+  std::string name;
+  std::string config_name;
+  json config;
+  std::shared_ptr<const onnx::ModelProto> model_proto;
+};
+
+struct BenchmarkResult {
+  std::string name;
+  cycle_type core_cycles;
+  double seconds;
+  double cycles_per_second;
+  uint64_t peak_rss_kb;
+};
+
+static json base_config() {
+  return json{{"core_type", "systolic_ws"}, {"core_freq", 1000},
+              {"sram_width", 32},           {"add_latency", 1},
+              {"mul_latency", 1},           {"exp_latency", 1},
+              {"gelu_latency", 1},          {"add_tree_latency", 1},
+              {"scalar_sqrt_latency", 1},   {"scalar_add_latency", 1},
+              {"scalar_mul_latency", 1},    {"dram_type", "simple"},
+              {"dram_latency", 10},         {"icnt_type", "simple"},
+              {"icnt_latency", 1},          {"icnt_freq", 2000},
+              {"precision", 2},             {"layout", "NHWC"},
+              {"scheduler", "simple"}};
+}
+
+/* A fixed hardware config and the model sizes simulated under it */
+struct BenchmarkConfig {
+  std::string name;
+  json config;
+  std::vector<uint32_t> gemm_sizes;
+  std::vector<uint32_t> conv_channels;
+  std::vector<uint32_t> seq_lens;
+};
+
+/* Modeled on the shipped systolic_ws_*_simple_noc configs but with the simple
+ * DRAM model so no Ramulator config file is needed. BERT-base heads do not
+ * fit the 8x8 scratchpad, so attention only runs on the large config. */
+static std::vector<BenchmarkConfig> fixed_configs() {
+  json small = base_config();
+  small.update(json{{"num_cores", 1}, {"core_width", 8}, {"core_height", 8},
+                    {"spad_size", 64}, {"accum_spad_size", 16},
+                    {"vector_process_bit", 32}, {"dram_freq", 1600},
+                    {"dram_channels", 2}, {"dram_req_size", 16}});
+  json large = base_config();
+  large.update(json{{"num_cores", 4}, {"core_width", 128}, {"core_height", 128},
+                    {"spad_size", 65536}, {"accum_spad_size", 8192},
+                    {"vector_process_bit", 65536}, {"dram_freq", 877},
+                    {"dram_channels", 32}, {"dram_req_size", 32}});
+  return {{.name = "systolic_ws_8x8_c1",
+           .config = small,
+           .gemm_sizes = {128, 256, 512, 1024},
+           .conv_channels = {64, 256, 1024},
+           .seq_lens = {}},
+          {.name = "systolic_ws_128x128_c4",
+           .config = large,
+           .gemm_sizes = {128, 256, 512, 1024, 2048},
+           .conv_channels = {64, 256, 1024},
+           .seq_lens = {128, 256, 512}}};
+}
+
+/* NxNxN Gemm, as in the speed comparison of the README */
+static std::shared_ptr<const onnx::ModelProto> gemm_model(uint32_t n) {
+  auto model_proto = std::make_shared<onnx::ModelProto>();
+  onnx::GraphProto* graph = model_proto->mutable_graph();
+  add_input(graph, "x", {n, n});
+  add_initializer(graph, "w", {n, n});
+  add_node(graph, "Gemm", "Gemm_0", {"x", "w"}, {"y"});
+  return model_proto;
+}
+
+/* 3x3 Conv with bias, as exported with batch norm folded in, from 64 to
+ * channels channels on a 14x14 NCHW input */
+static std::shared_ptr<const onnx::ModelProto> conv_model(uint32_t channels) {
+  auto model_proto = std::make_shared<onnx::ModelProto>();
+  onnx::GraphProto* graph = model_proto->mutable_graph();
+  add_input(graph, "x", {1, 64, 14, 14});
+  add_initializer(graph, "w", {channels, 64, 3, 3});
+  add_initializer(graph, "b", {channels});
+  onnx::NodeProto* node = add_node(graph, "Conv", "Conv_0", {"x", "w", "b"}, {"y"});
+  add_ints(node, "kernel_shape", {3, 3});
+  add_ints(node, "strides", {1, 1});
+  add_ints(node, "pads", {1, 1, 1, 1});
+  add_ints(node, "dilations", {1, 1});
+  add_int(node, "group", 1);
+  return model_proto;
+}
+
+/* Fused multi-head attention of a BERT-base sized layer over seq tokens */
+static std::shared_ptr<const onnx::ModelProto> attention_model(uint32_t seq) {
+  const uint32_t dmodel = 768;
+  auto model_proto = std::make_shared<onnx::ModelProto>();
+  onnx::GraphProto* graph = model_proto->mutable_graph();
+  add_input(graph, "x", {1, seq, dmodel});
+  add_initializer(graph, "w", {dmodel, 3 * dmodel});
+  add_initializer(graph, "b", {3 * dmodel});
+  add_initializer(graph, "mask", {1, seq});
+  onnx::NodeProto* node =
+      add_node(graph, "Attention", "Attention_0", {"x", "w", "b", "mask"}, {"y"});
+  add_int(node, "num_heads", 12);
+  return model_proto;
+}
+
+/* Sizes grow by powers of two; quick keeps the smallest of each kind */
+static std::vector<BenchmarkCase> benchmark_cases(bool quick) {
+  std::vector<BenchmarkCase> cases;
+  for (auto& fixed : fixed_configs()) {
+    if (quick) {
+      fixed.gemm_sizes.resize(MIN(fixed.gemm_sizes.size(), 1));
+      fixed.conv_channels.resize(MIN(fixed.conv_channels.size(), 1));
+      fixed.seq_lens.resize(MIN(fixed.seq_lens.size(), 1));
+    }
+    for (uint32_t n : fixed.gemm_sizes)
+      cases.push_back({fmt::format("gemm_{}", n), fixed.name, fixed.config, gemm_model(n)});
+    for (uint32_t channels : fixed.conv_channels)
+      cases.push_back({fmt::format("conv_{}", channels), fixed.name, fixed.config,
+                       conv_model(channels)});
+    for (uint32_t seq : fixed.seq_lens)
+      cases.push_back({fmt::format("attention_{}", seq), fixed.name, fixed.config,
+                       attention_model(seq)});
+  }
+  return cases;
+}
+
+/* Writing 5 to clear_refs resets the peak RSS (VmHWM) of the process to the
+ * current RSS, so every case reports its own peak once the heap left by the
+ * previous case is returned; without it the process peak is used */
+static void reset_peak_rss() {
+  malloc_trim(0);
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  if (clear_refs.is_open())
+    clear_refs << "5";
+}
+
+static uint64_t peak_rss_kb() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("VmHWM:", 0) == 0)
+      return std::stoull(line.substr(6));
+  }
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+static BenchmarkResult run_case(const BenchmarkCase& benchmark,
+                                spdlog::level::level_enum level) {
+  std::string name = benchmark.config_name + "/" + benchmark.name;
+  reset_peak_rss();
+  auto start = std::chrono::steady_clock::now();
+  spdlog::set_level(level);
+  auto simulator = Simulator::create(benchmark.config);
+  simulator->register_model(json{{"name", benchmark.name}}, benchmark.name + ".onnx",
+                            benchmark.name + ".mapping", benchmark.model_proto);
+  simulator->step(UINT64_MAX);
+  cycle_type core_cycles = simulator->get_core_cycles();
+  simulator.reset();
+  spdlog::set_level(spdlog::level::info);
+  std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+  double seconds = duration.count();
+  BenchmarkResult result = {.name = name,
+                            .core_cycles = core_cycles,
+                            .seconds = seconds,
+                            .cycles_per_second = seconds > 0 ? core_cycles / seconds : 0,
+                            .peak_rss_kb = peak_rss_kb()};
+  spdlog::info("{:<40} {:>12} cycles {:>9.3f} s {:>12.0f} cycles/s {:>9} KB", name,
+               result.core_cycles, result.seconds, result.cycles_per_second,
+               result.peak_rss_kb);
+  return result;
+}
+
+static void write_results(std::string path, const std::vector<BenchmarkResult>& results) {
+  std::ofstream file(path);
+  if (!file.is_open()) {
+    spdlog::error("Failed to open benchmark output {}", path);
+    exit(EXIT_FAILURE);
+  }
+  file << "name,core_cycles,seconds,cycles_per_second,peak_rss_kb\n";
+  for (auto& result : results)
+    file << fmt::format("{},{},{:.6f},{:.0f},{}\n", result.name, result.core_cycles,
+                        result.seconds, result.cycles_per_second, result.peak_rss_kb);
+  spdlog::info("Benchmark results: {}", path);
+}
+
+/* Cases shorter than this on either run are dominated by timer and cache
+ * noise and are not compared */
+static constexpr double MIN_COMPARE_SECONDS = 0.5;
+
+/* Number of cases slower than baseline by more than tolerance */
+static int compare_baseline(std::string path, const std::vector<BenchmarkResult>& results,
+                            double tolerance) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    spdlog::error("Failed to open benchmark baseline {}", path);
+    exit(EXIT_FAILURE);
+  }
+  std::map<std::string, BenchmarkResult> baseline;
+  std::string line;
+  std::getline(file, line);
+  while (std::getline(file, line)) {
+    std::stringstream row(line);
+    std::string name, core_cycles, seconds, cycles_per_second, peak_rss;
+    std::getline(row, name, ',');
+    std::getline(row, core_cycles, ',');
+    std::getline(row, seconds, ',');
+    std::getline(row, cycles_per_second, ',');
+    std::getline(row, peak_rss, ',');
+    if (name.empty())
+      continue;
+    baseline[name] = {.name = name,
+                      .core_cycles = std::stoull(core_cycles),
+                      .seconds = std::stod(seconds),
+                      .cycles_per_second = std::stod(cycles_per_second),
+                      .peak_rss_kb = std::stoull(peak_rss)};
+  }
+
+  int regressions = 0;
+  for (auto& result : results) {
+    auto it = baseline.find(result.name);
+    if (it == baseline.end())
+      continue;
+    const BenchmarkResult& reference = it->second;
+    if (result.core_cycles != reference.core_cycles)
+      spdlog::warn("{}: simulated cycles changed from {} to {}", result.name,
+                   reference.core_cycles, result.core_cycles);
+    if (result.seconds < MIN_COMPARE_SECONDS || reference.seconds < MIN_COMPARE_SECONDS)
+      continue;
+    double speedup = reference.cycles_per_second > 0
+                         ? result.cycles_per_second / reference.cycles_per_second
+                         : 1;
+    if (speedup < 1 - tolerance) {
+      spdlog::error("{}: {:.0f} cycles/s is {:.1f}% slower than baseline {:.0f} cycles/s",
+                    result.name, result.cycles_per_second, (1 - speedup) * 100,
+                    reference.cycles_per_second);
+      regressions++;
+    }
+  }
+  return regressions;
+}
+
+int main(int argc, char** argv) {
+  CommandLineParser cmd_parser = CommandLineParser();
+  cmd_parser.add_command_line_option<std::string>(
+      "log_level", "Set for simulator log level [trace, debug, info, warn], default = warn");
+  cmd_parser.add_command_line_option<bool>(
+      "quick", "Run only the smallest model of each kind, default = false");
+  cmd_parser.add_command_line_option<std::string>(
+      "filter", "Run only the cases whose name contains this string");
+  cmd_parser.add_command_line_option<std::string>(
+      "output", "Path for the benchmark results, default = benchmark.csv");
+  cmd_parser.add_command_line_option<std::string>(
+      "baseline", "Path for earlier results to compare cycles/s against");
+  cmd_parser.add_command_line_option<double>(
+      "tolerance", "Allowed cycles/s slowdown against the baseline, default = 0.2");
+  try {
+    cmd_parser.parse(argc, argv);
+  } catch (const CommandLineParser::ParsingError& e) {
+    spdlog::error("Command line argument parsing error captured. Error message: {}",
+                  e.what());
+    throw(e);
+  }
+  cmd_parser.print_help_message_if_required();
+
+  std::string level_name = "warn";
+  cmd_parser.set_if_defined("log_level", &level_name);
+  spdlog::level::level_enum level = spdlog::level::from_str(level_name);
+
+  bool quick = false;
+  std::string filter;
+  std::string output_path = "benchmark.csv";
+  std::string baseline_path;
+  double tolerance = 0.2;
+  cmd_parser.set_if_defined("quick", &quick);
+  cmd_parser.set_if_defined("filter", &filter);
+  cmd_parser.set_if_defined("output", &output_path);
+  cmd_parser.set_if_defined("baseline", &baseline_path);
+  cmd_parser.set_if_defined("tolerance", &tolerance);
+
+  std::vector<BenchmarkResult> results;
+  for (auto& benchmark : benchmark_cases(quick)) {
+    if (!filter.empty() &&
+        (benchmark.config_name + "/" + benchmark.name).find(filter) == std::string::npos)
+      continue;
+    results.push_back(run_case(benchmark, level));
+  }
+  write_results(output_path, results);
+
+  if (!baseline_path.empty()) {
+    int regressions = compare_baseline(baseline_path, results, tolerance);
+    if (regressions > 0) {
+      spdlog::error("{} benchmark cases regressed", regressions);
+      return EXIT_FAILURE;
+    }
+    spdlog::info("No benchmark case regressed beyond {:.0f}%", tolerance * 100);
+  }
+  return 0;
+}
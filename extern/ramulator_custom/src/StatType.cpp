@@ -3,17 +3,22 @@
 namespace Stat {
 
 // Statistics list
-StatList statlist;
+thread_local StatList statlist;
 
 // The smallest timing granularity.
 Tick curTick = 0;
 
-std::vector<StatBase*> all_stats;
+thread_local std::vector<StatBase*> all_stats;
 void reset_stats() {
     for(auto s : all_stats)
         s->reset();
 }
 
+StatBase::~StatBase() {
+    all_stats.erase(std::remove(all_stats.begin(), all_stats.end(), this), all_stats.end());
+    statlist.remove(this);
+}
+
 void
 Histogram::grow_out()
 {
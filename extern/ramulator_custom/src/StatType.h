@@ -1,6 +1,7 @@
 #ifndef __STATTYPE_H
 #define __STATTYPE_H
 
+#include <algorithm>
 #include <limits>
 #include <fstream>
 #include <string>
@@ -32,7 +33,8 @@ typedef std::vector<Result> VResult;
 typedef std::numeric_limits<Counter> CounterLimits;
 
 class StatBase;
-extern std::vector<StatBase*> all_stats;
+// Per thread, so memories of independent simulations run side by side
+extern thread_local std::vector<StatBase*> all_stats;
 void reset_stats();
 
 // Flags
@@ -65,6 +67,7 @@ class StatBase {
     StatBase() {
         all_stats.push_back(this);
     }
+    virtual ~StatBase();
 
 
   // TODO implement print for Distribution, Histogram,
@@ -91,7 +94,13 @@ class StatList {
   void add(StatBase* stat) {
     list.push_back(stat);
   }
+  void remove(StatBase* stat) {
+    list.erase(std::remove(list.begin(), list.end(), stat), list.end());
+  }
   void output(std::string filename) {
+    if (stat_output.is_open()) {
+      return;
+    }
     stat_output.open(filename.c_str(), std::ios_base::out);
     if (!stat_output.good()) {
       assert(false && "!stat_output.good()");
@@ -116,7 +125,7 @@ class StatList {
   }
 };
 
-extern StatList statlist;
+extern thread_local StatList statlist;
 
 template<class Derived>
 class Stat : public StatBase {
@@ -0,0 +1,143 @@
+#include "AnalyticalModel.h"
+
+#include "helper/HelperFunctions.h"
+
+AnalyticalModel::Estimate AnalyticalModel::estimate(std::deque<std::unique_ptr<Tile>>& tiles,
+                                                    uint32_t num_cores) {
+  Estimate estimate;
+  num_cores = MAX(num_cores, 1);
+  /* Tiles land on cores as the schedulers spread them: by core id, else round robin */
+  std::vector<cycle_type> core_compute(num_cores, 0);
+  std::vector<uint64_t> core_bytes(num_cores, 0);
+  std::vector<cycle_type> core_cycles(num_cores, 0);
+
+  /*
+   * A core moves one request per interconnect cycle, and every DRAM channel
+   * one request per DRAM cycle shared by all cores.
+   */
+  double core_bandwidth = (double)_config.dram_req_size * _config.icnt_freq / _config.core_freq;
+  double dram_bandwidth = (double)_config.dram_channels * _config.dram_req_size *
+                          _config.dram_freq / _config.core_freq;
+  /* The systolic array drains between tiles: weight preload and pipeline fill */
+  cycle_type fill_cycles = 3 * _config.core_height + _config.core_width - 3;
+  uint32_t next_core = 0;
+  for (auto& tile : tiles) {
+    if (tile->status == Tile::Status::BAR || tile->skip)
+      continue;
+    uint32_t core_id = tile->core_id >= 0 ? tile->core_id % num_cores : next_core++ % num_cores;
+    uint64_t read_bytes = 0;
+    uint64_t write_bytes = 0;
+    for (auto& inst : tile->instructions) {
+      if (inst->opcode == Opcode::MOVIN)
+        read_bytes += inst->src_addrs.size() * _config.dram_req_size;
+      else if (inst->opcode == Opcode::MOVOUT || inst->opcode == Opcode::MOVOUT_POOL)
+        write_bytes += inst->src_addrs.size() * _config.dram_req_size;
+    }
+    estimate.tiles++;
+    estimate.read_bytes += read_bytes;
+    estimate.write_bytes += write_bytes;
+    /* Loads stream under the GEMMs of a tile, which runs at the slower of the two */
+    cycle_type compute_cycles = get_tile_compute_cycles(tile.get());
+    cycle_type memory_cycles = (read_bytes + write_bytes) / core_bandwidth;
+    core_compute[core_id] += compute_cycles;
+    core_bytes[core_id] += read_bytes + write_bytes;
+    core_cycles[core_id] += MAX(compute_cycles, memory_cycles) + fill_cycles;
+  }
+
+  cycle_type bound = 0;
+  for (uint32_t core_id = 0; core_id < num_cores; core_id++) {
+    estimate.compute_cycles = MAX(estimate.compute_cycles, core_compute[core_id]);
+    estimate.memory_cycles =
+        MAX(estimate.memory_cycles, (cycle_type)(core_bytes[core_id] / core_bandwidth));
+    bound = MAX(bound, core_cycles[core_id]);
+  }
+  cycle_type dram_cycles = (estimate.read_bytes + estimate.write_bytes) / dram_bandwidth;
+  estimate.memory_cycles = MAX(estimate.memory_cycles, dram_cycles);
+  bound = MAX(bound, dram_cycles);
+
+  /* Exposed DRAM latency of the first load and last store, queued as in M/D/1 */
+  double utilization = bound ? MIN((double)estimate.memory_cycles / bound, 0.95) : 0;
+  double dram_latency = (double)_config.dram_latency * _config.core_freq / _config.dram_freq +
+                        2 * _config.icnt_latency * _config.core_freq / _config.icnt_freq;
+  double queueing_latency = dram_latency * (1 + utilization / (2 * (1 - utilization)));
+  estimate.cycles = bound + (cycle_type)(2 * queueing_latency);
+  return estimate;
+}
+
+AnalyticalModel::Estimate AnalyticalModel::convert_tiles(std::deque<std::unique_ptr<Tile>>& tiles,
+                                                         uint32_t num_cores) {
+  Estimate estimate = this->estimate(tiles, num_cores);
+  replace_tiles(tiles, num_cores, estimate.cycles, estimate.compute_cycles);
+  return estimate;
+}
+
+void AnalyticalModel::replace_tiles(std::deque<std::unique_ptr<Tile>>& tiles, uint32_t num_cores,
+                                    cycle_type cycles, cycle_type compute_cycles) {
+  if (tiles.empty())
+    return;
+  std::string optype = tiles.front()->optype;
+  uint32_t layer_id = tiles.front()->layer_id;
+  tiles.clear();
+  /* Distinct core ids spread the tiles over the cores of the partition */
+  for (uint32_t core_id = 0; core_id < MAX(num_cores, 1); core_id++) {
+    tiles.push_back(std::make_unique<Tile>(Tile{.status = Tile::Status::INITIALIZED,
+                                                .optype = optype,
+                                                .layer_id = layer_id,
+                                                .accum = false,
+                                                .skip = false,
+                                                .core_id = (int)core_id,
+                                                .analytical_cycles = MAX(cycles, 1),
+                                                .analytical_compute_cycles =
+                                                    MIN(compute_cycles, MAX(cycles, 1))}));
+  }
+}
+
+cycle_type AnalyticalModel::get_tile_compute_cycles(Tile* tile) {
+  /* Systolic array issues back to back once the pipeline is filled */
+  cycle_type systolic_cycles = 0;
+  cycle_type vector_cycles = 0;
+  for (auto& inst : tile->instructions) {
+    switch (inst->opcode) {
+      case Opcode::GEMM:
+        systolic_cycles += MAX(inst->compute_size, 4);
+        break;
+      case Opcode::GEMM_PRELOAD:
+        systolic_cycles += _config.core_height;
+        break;
+      case Opcode::COMP:
+      case Opcode::SOFTMAX:
+      case Opcode::LAYERNORM:
+      case Opcode::ADD:
+      case Opcode::GELU:
+        vector_cycles += get_vector_compute_cycles(inst.get());
+        break;
+      default:
+        break;
+    }
+  }
+  return MAX(systolic_cycles, vector_cycles);
+}
+
+/* Closed form of SystolicWS::get_vector_compute_cycles */
+cycle_type AnalyticalModel::get_vector_compute_cycles(Instruction* inst) {
+  uint32_t lanes = MAX(_config.vector_process_bit >> 3, 1);
+  cycle_type iterations = (inst->compute_size + lanes - 1) / lanes;
+  cycle_type add_tree = 1;
+  for (cycle_type width = iterations; width > 1; width = (width + lanes - 1) / lanes)
+    add_tree += width;
+  switch (inst->opcode) {
+    case Opcode::LAYERNORM:
+      return 2 * add_tree * _config.add_tree_latency + 2 * _config.scalar_mul_latency +
+             _config.scalar_sqrt_latency +
+             iterations * (2 * _config.add_latency + 3 * _config.mul_latency) * inst->tile_m;
+    case Opcode::SOFTMAX:
+      return 2 * add_tree * _config.add_tree_latency * inst->tile_m +
+             iterations * (_config.add_latency + _config.exp_latency + _config.mul_latency);
+    case Opcode::ADD:
+      return iterations * _config.add_latency;
+    case Opcode::GELU:
+      return iterations * _config.gelu_latency;
+    default:
+      return iterations;
+  }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Common.h"
+
+/*
+ * Roofline/queueing estimate of a layer run on a group of cores, derived from
+ * the tiles its mapping produces. Layers selected for analytical mode are
+ * charged this latency instead of being simulated cycle by cycle.
+ */
+class AnalyticalModel {
+ public:
+  struct Estimate {
+    cycle_type cycles = 0;
+    cycle_type compute_cycles = 0; /* Busiest core */
+    cycle_type memory_cycles = 0;  /* Busiest core link or DRAM */
+    uint64_t read_bytes = 0;
+    uint64_t write_bytes = 0;
+    uint32_t tiles = 0;
+  };
+
+  AnalyticalModel(SimulationConfig config) : _config(config) {}
+  Estimate estimate(std::deque<std::unique_ptr<Tile>>& tiles, uint32_t num_cores);
+  /* Replace tiles by one fixed-latency tile per core, compute_cycles of it computing */
+  Estimate convert_tiles(std::deque<std::unique_ptr<Tile>>& tiles, uint32_t num_cores);
+  static void replace_tiles(std::deque<std::unique_ptr<Tile>>& tiles, uint32_t num_cores,
+                            cycle_type cycles, cycle_type compute_cycles);
+
+ private:
+  cycle_type get_tile_compute_cycles(Tile* tile);
+  cycle_type get_vector_compute_cycles(Instruction* inst);
+
+  SimulationConfig _config;
+};
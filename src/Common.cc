@@ -1,16 +1,64 @@
 #include "Common.h"
 
+#include <atomic>
+#include <cmath>
+#include <mutex>
+
+void AddressList::push_back(addr_type addr) {
+  _size++;
+  if (!_runs.empty()) {
+    Run& run = _runs.back();
+    if (run.total == 1) {
+      run.stride = addr - run.base;
+      run.count = run.total = 2;
+      return;
+    }
+    if (run.total == run.count) {
+      /* Single row: extend it or start the second row */
+      if (addr == run.base + run.total * run.stride) {
+        run.count++;
+        run.total++;
+      } else {
+        run.outer_stride = addr - run.base;
+        run.total++;
+      }
+      return;
+    }
+    if (addr == run.at(run.total)) {
+      run.total++;
+      return;
+    }
+  }
+  _runs.push_back(Run{.base = addr, .stride = 0, .outer_stride = 0, .count = 1, .total = 1});
+}
+
+/* Operations may generate tiles and cores issue requests on worker threads */
+static AllocationContext default_context;
+static thread_local AllocationContext* current_context = &default_context;
+
+AllocationContext* get_allocation_context() {
+  return current_context;
+}
+
+void bind_allocation_context(AllocationContext* context) {
+  current_context = context != nullptr ? context : &default_context;
+}
+
 uint32_t generate_id() {
-  static uint32_t id_counter{0};
-  return id_counter++;
+  return generate_ids(1);
+}
+
+/* Reserve count consecutive ids and return the first (count 0: next id) */
+uint32_t generate_ids(uint32_t count) {
+  return current_context->next_id.fetch_add(count, std::memory_order_relaxed);
 }
 uint32_t generate_mem_access_id() {
-  static uint32_t id_counter{0};
-  return id_counter++;
+  return current_context->next_mem_access_id.fetch_add(1, std::memory_order_relaxed);
 }
 
 addr_type allocate_address(uint32_t size) {
-  static addr_type base_addr{0};
+  std::lock_guard<std::mutex> lock(current_context->address_mutex);
+  addr_type& base_addr = current_context->next_address;
   addr_type result = base_addr;
   int offset = 0;
   if (result % 256 != 0) {
@@ -23,6 +71,33 @@ addr_type allocate_address(uint32_t size) {
   return result;
 }
 
+/*
+ * Reserve [result, result + size) as is, so a range recorded between two
+ * calls can be replayed elsewhere (size 0: next address)
+ */
+addr_type allocate_address_range(addr_type size) {
+  std::lock_guard<std::mutex> lock(current_context->address_mutex);
+  addr_type& base_addr = current_context->next_address;
+  assert(base_addr % 256 == 0 && size % 256 == 0);
+  addr_type result = base_addr;
+  base_addr += size;
+  return result;
+}
+
+AllocationState get_allocation_state() {
+  std::lock_guard<std::mutex> lock(current_context->address_mutex);
+  return AllocationState{.next_id = current_context->next_id.load(),
+                         .next_mem_access_id = current_context->next_mem_access_id.load(),
+                         .next_address = current_context->next_address};
+}
+
+void set_allocation_state(AllocationState state) {
+  std::lock_guard<std::mutex> lock(current_context->address_mutex);
+  current_context->next_id.store(state.next_id);
+  current_context->next_mem_access_id.store(state.next_mem_access_id);
+  current_context->next_address = state.next_address;
+}
+
 SimulationConfig initialize_config(json config) {
   SimulationConfig parsed_config;
 
@@ -73,6 +148,8 @@ SimulationConfig initialize_config(json config) {
     parsed_config.dram_req_size = config["dram_req_size"];
   if (config.contains("dram_print_interval"))
     parsed_config.dram_print_interval = config["dram_print_interval"];
+  if (config.contains("dram_burst_length"))
+    parsed_config.dram_burst_length = config["dram_burst_length"];
 
   /* Icnt config */
   if ((std::string)config["icnt_type"] == "simple")
@@ -89,8 +166,50 @@ SimulationConfig initialize_config(json config) {
     parsed_config.icnt_config_path = config["icnt_config_path"];
 
   parsed_config.scheduler_type = config["scheduler"];
+  if (config.contains("max_active_layers"))
+    parsed_config.max_active_layers = config["max_active_layers"];
+  if (config.contains("work_stealing"))
+    parsed_config.work_stealing = config["work_stealing"];
   parsed_config.precision = config["precision"];
   parsed_config.layout = config["layout"];
+  if (config.contains("fast_forward"))
+    parsed_config.fast_forward = config["fast_forward"];
+  if (config.contains("num_threads"))
+    parsed_config.num_threads = config["num_threads"];
+  if (config.contains("model_cache_dir"))
+    parsed_config.model_cache_dir = config["model_cache_dir"];
+  if (config.contains("tile_memo_threshold"))
+    parsed_config.tile_memo_threshold = config["tile_memo_threshold"];
+  if (config.contains("tile_memo_validate_interval"))
+    parsed_config.tile_memo_validate_interval = config["tile_memo_validate_interval"];
+  if (config.contains("analytical_ops"))
+    parsed_config.analytical_ops = config["analytical_ops"].get<std::vector<std::string>>();
+  if (config.contains("sample_min_tiles"))
+    parsed_config.sample_min_tiles = config["sample_min_tiles"];
+  if (config.contains("sample_warmup_tiles"))
+    parsed_config.sample_warmup_tiles = config["sample_warmup_tiles"];
+  if (config.contains("sample_interval_tiles"))
+    parsed_config.sample_interval_tiles = config["sample_interval_tiles"];
+  if (config.contains("sample_rate"))
+    parsed_config.sample_rate = config["sample_rate"];
+  if (config.contains("block_detail_count"))
+    parsed_config.block_detail_count = config["block_detail_count"];
+  if (config.contains("checkpoint_interval"))
+    parsed_config.checkpoint_interval = config["checkpoint_interval"];
+  if (config.contains("checkpoint_dir"))
+    parsed_config.checkpoint_dir = config["checkpoint_dir"];
+  if (config.contains("stats_path"))
+    parsed_config.stats_path = config["stats_path"];
+  if (config.contains("stats_tiles"))
+    parsed_config.stats_tiles = config["stats_tiles"];
+  if (config.contains("trace_path"))
+    parsed_config.trace_path = config["trace_path"];
+  if (config.contains("trace_interval"))
+    parsed_config.trace_interval = config["trace_interval"];
+  if (config.contains("host_profile"))
+    parsed_config.host_profile = config["host_profile"];
+  if (config.contains("host_profile_interval"))
+    parsed_config.host_profile_interval = config["host_profile_interval"];
 
   if (config.contains("partition")) {
     for (int i=0; i<parsed_config.num_cores; i++) {
@@ -107,4 +226,11 @@ SimulationConfig initialize_config(json config) {
     }
   }
   return parsed_config;
-}
\ No newline at end of file
+}
+
+uint64_t percentile(const std::vector<uint64_t>& sorted, double p) {
+  if (sorted.empty())
+    return 0;
+  size_t rank = (size_t)std::ceil(p / 100 * sorted.size());
+  return sorted[MAX(rank, (size_t)1) - 1];
+}
@@ -4,10 +4,12 @@
 #include <spdlog/fmt/ranges.h>
 #include <spdlog/spdlog.h>
 
+#include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <string>
 #include <vector>
@@ -32,6 +34,77 @@ using json = nlohmann::json;
 typedef uint64_t addr_type;
 typedef uint64_t cycle_type;
 
+/*
+ * Compact address list for instruction operands. Addresses are appended in
+ * order and stored as strided runs: element k of a run is
+ *   base + (k / count) * outer_stride + (k % count) * stride
+ * so a tile row (or a 2D block of rows) costs one run instead of one entry
+ * per DRAM request. Iteration expands the runs lazily.
+ */
+class AddressList {
+ public:
+  struct Run {
+    addr_type base;
+    addr_type stride;
+    addr_type outer_stride;
+    uint32_t count;
+    uint32_t total;
+    addr_type at(uint32_t k) const {
+      return base + (k / count) * outer_stride + (k % count) * stride;
+    }
+  };
+
+  class iterator {
+   public:
+    iterator(const std::vector<Run>* runs, size_t run, uint32_t k)
+        : _runs(runs), _run(run), _k(k) {}
+    addr_type operator*() const { return (*_runs)[_run].at(_k); }
+    iterator& operator++() {
+      if (++_k == (*_runs)[_run].total) {
+        _run++;
+        _k = 0;
+      }
+      return *this;
+    }
+    bool operator==(const iterator& other) const {
+      return _run == other._run && _k == other._k;
+    }
+    bool operator!=(const iterator& other) const { return !(*this == other); }
+
+   private:
+    const std::vector<Run>* _runs;
+    size_t _run;
+    uint32_t _k;
+  };
+
+  AddressList() = default;
+  AddressList(std::initializer_list<addr_type> addrs)
+      : AddressList(addrs.begin(), addrs.end()) {}
+  AddressList(const std::vector<addr_type>& addrs)
+      : AddressList(addrs.begin(), addrs.end()) {}
+  template <typename InputIt>
+  AddressList(InputIt first, InputIt last) {
+    for (; first != last; ++first) push_back(*first);
+    _runs.shrink_to_fit();
+  }
+
+  void push_back(addr_type addr);
+  void append_run(const Run& run) {
+    _runs.push_back(run);
+    _size += run.total;
+  }
+  const std::vector<Run>& get_runs() const { return _runs; }
+  size_t size() const { return _size; }
+  bool empty() const { return _size == 0; }
+  size_t num_runs() const { return _runs.size(); }
+  iterator begin() const { return iterator(&_runs, 0, 0); }
+  iterator end() const { return iterator(&_runs, _runs.size(), 0); }
+
+ private:
+  std::vector<Run> _runs;
+  size_t _size = 0;
+};
+
 typedef struct {
   uint32_t id;
   addr_type dram_address;
@@ -72,7 +145,7 @@ typedef struct {
   addr_type dest_addr;
   uint32_t size;          // Used for sram allocation. Multiple of _config.dram_req_size
   uint32_t compute_size;
-  std::vector<addr_type> src_addrs;
+  AddressList src_addrs;
   int spad_id;
   int accum_spad_id;
   uint32_t operand_id  = 0;
@@ -94,6 +167,13 @@ typedef struct {
     BAR,
     EMPTY,
   };
+  /* Sampled simulation: warm-up and sample tiles run in detail, the rest are extrapolated */
+  enum class Sampling {
+    NONE,
+    WARMUP,
+    SAMPLE,
+    EXTRAPOLATE,
+  };
   Status status = Status::EMPTY;
   std::string optype;
   uint32_t layer_id;
@@ -113,9 +193,49 @@ typedef struct {
   int spad_id;
   int accum_spad_id;
   int core_id = -1;
+  cycle_type analytical_cycles = 0; /* Fixed latency of an analytically estimated layer */
+  cycle_type analytical_compute_cycles = 0; /* Share of analytical_cycles spent computing */
+  Sampling sampling = Sampling::NONE;
 } Tile;
 
 uint32_t generate_id();
+uint32_t generate_ids(uint32_t count);
 uint32_t generate_mem_access_id();
 addr_type allocate_address(uint32_t size);
-SimulationConfig initialize_config(json config);
\ No newline at end of file
+addr_type allocate_address_range(addr_type size);
+/* Ids and DRAM space handed out so far, restored from checkpoints */
+struct AllocationState {
+  uint32_t next_id;
+  uint32_t next_mem_access_id;
+  addr_type next_address;
+};
+AllocationState get_allocation_state();
+void set_allocation_state(AllocationState state);
+/*
+ * Counters behind the functions above. Each thread uses the context bound to
+ * it, or a process-wide one, so simulations run side by side stay apart.
+ */
+struct AllocationContext {
+  std::atomic<uint32_t> next_id{0};
+  std::atomic<uint32_t> next_mem_access_id{0};
+  addr_type next_address = 0;
+  std::mutex address_mutex;
+};
+AllocationContext* get_allocation_context();
+void bind_allocation_context(AllocationContext* context);
+/* Binds a context to the calling thread until the end of the scope */
+class AllocationScope {
+ public:
+  AllocationScope(AllocationContext* context) : _previous(get_allocation_context()) {
+    bind_allocation_context(context);
+  }
+  ~AllocationScope() { bind_allocation_context(_previous); }
+  AllocationScope(const AllocationScope&) = delete;
+  AllocationScope& operator=(const AllocationScope&) = delete;
+
+ private:
+  AllocationContext* _previous;
+};
+SimulationConfig initialize_config(json config);
+/* Nearest-rank percentile (0-100] of sorted values, 0 if there are none */
+uint64_t percentile(const std::vector<uint64_t>& sorted, double p);
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include "Core.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "helper/HelperFunctions.h"
 
 Core::Core(uint32_t id, SimulationConfig config)
@@ -10,6 +13,9 @@ Core::Core(uint32_t id, SimulationConfig config)
       _stat_idle_cycle(0),
       _stat_compute_cycle(0),
       _stat_memory_cycle(0),
+      _accum_request_rr_cycle(0),
+      _max_request_rr_cycle(0),
+      _min_request_rr_cycle(0),
       _stat_vec_compute_cycle(0),
       _stat_vec_memory_cycle(0),
       _stat_vec_idle_cycle(0),
@@ -31,10 +37,12 @@ Core::Core(uint32_t id, SimulationConfig config)
   _running_layer = -1;
   _current_spad = 0;
   _current_acc_spad = 0;
+  _current_layer_id = 0;
+  _current_fused_op_id = 0;
 }
 
 bool Core::can_issue(bool is_accum_tile) {
-  return _tiles.size() < 1;  // double buffer
+  return _tiles.size() < 1 && !_replay_tile;  // double buffer
 }
 
 void Core::issue(std::unique_ptr<Tile> op) {
@@ -43,7 +51,8 @@ void Core::issue(std::unique_ptr<Tile> op) {
              .compute_cycles = 0,
              .memory_stall = 0,
              .sram_reads = 0,
-             .sram_writes = 0};
+             .sram_writes = 0,
+             .core_id = _id};
   /* Double buffer */
   _current_spad = (_current_spad + 1) % 2;
   _spad.flush(_current_spad);
@@ -66,9 +75,179 @@ void Core::issue(std::unique_ptr<Tile> op) {
   if (_running_layer != op->layer_id) {
     _running_layer = op->layer_id;
   }
+  if (op->sampling == Tile::Sampling::NONE)
+    _sample_pending = false;
+  if (op->analytical_cycles > 0) {
+    /* Analytically estimated layer: hold the core for the estimated latency */
+    _stat_analytical_tiles++;
+    _stat_analytical_cycles += op->analytical_cycles;
+    replay_tile(op, op->analytical_cycles, op->analytical_compute_cycles);
+    return;
+  }
+  if (op->sampling != Tile::Sampling::NONE && issue_sampled_tile(op))
+    return;
+  if (_config.tile_memo_threshold > 0 && issue_memoized_tile(op))
+    return;
   _tiles.push_back(std::move(op));
 }
 
+/*
+ * Tiles with the same signature (op type, accumulation, tile shape as seen in
+ * the instruction sizes, number of active cores and whether this core is
+ * busy) are simulated in full tile_memo_threshold times, measuring how long
+ * each holds the core before the next tile of its layer issues. Later
+ * instances occupy the core for the median of those samples and are charged
+ * their DRAM traffic without issuing instructions; every
+ * tile_memo_validate_interval-th one still runs in full and its error against
+ * the learned latency is reported.
+ */
+bool Core::issue_memoized_tile(std::unique_ptr<Tile>& tile) {
+  if (_memo_sample_pending && _memo_sample_layer_id == tile->layer_id) {
+    TileMemo& memo = _tile_memo[_memo_sample_signature];
+    cycle_type cycles = _core_cycle - _memo_sample_issue_cycle;
+    if (_memo_sample_validation) {
+      _stat_memo_validations++;
+      _stat_memo_error += std::abs((double)memo.cycles - cycles) / MAX(cycles, 1);
+    } else {
+      memo.samples.push_back(cycles);
+      memo.compute_samples.push_back(MIN(_last_tile_compute_cycles, cycles));
+      /* The median ignores the pipeline fill of the first tiles of a layer */
+      if (memo.samples.size() == _config.tile_memo_threshold) {
+        size_t median = memo.samples.size() / 2;
+        std::nth_element(memo.samples.begin(), memo.samples.begin() + median,
+                         memo.samples.end());
+        std::nth_element(memo.compute_samples.begin(), memo.compute_samples.begin() + median,
+                         memo.compute_samples.end());
+        memo.cycles = MAX(memo.samples[median], 1);
+        memo.compute_cycles = MIN(memo.compute_samples[median], memo.cycles);
+      }
+    }
+  }
+  _memo_sample_pending = false;
+
+  uint64_t signature = 0xcbf29ce484222325ULL;
+  auto hash = [&signature](uint64_t value) {
+    signature = (signature ^ value) * 0x100000001b3ULL;
+  };
+  hash(std::hash<std::string>{}(tile->optype));
+  hash(tile->accum);
+  hash(_memory_context);
+  /* Tiles issued back to back overlap their predecessor; a cold start does not */
+  hash(running() || _last_tile_finish_cycle == _core_cycle);
+  for (auto& inst : tile->instructions) {
+    hash((uint64_t)inst->opcode);
+    /* Load/store sizes count the DRAM atoms touched, which vary with padding */
+    if (inst->opcode == Opcode::MOVIN || inst->opcode == Opcode::MOVOUT ||
+        inst->opcode == Opcode::MOVOUT_POOL)
+      continue;
+    hash(inst->size);
+    hash(inst->compute_size);
+    hash(((uint64_t)inst->tile_m << 32) ^ ((uint64_t)inst->tile_k << 16) ^ inst->tile_n);
+  }
+  TileMemo& memo = _tile_memo[signature];
+  bool validation = false;
+  if (memo.cycles > 0) {
+    memo.replays++;
+    validation = _config.tile_memo_validate_interval > 0 &&
+                 memo.replays % _config.tile_memo_validate_interval == 0;
+    if (!validation) {
+      cycle_type cycles = memo.cycles;
+      for (auto& inst : tile->instructions) {
+        if (inst->opcode == Opcode::MOVIN)
+          _stat_memo_read_bytes += inst->src_addrs.size() * _config.dram_req_size;
+        else if (inst->opcode == Opcode::MOVOUT || inst->opcode == Opcode::MOVOUT_POOL)
+          _stat_memo_write_bytes += inst->src_addrs.size() * _config.dram_req_size;
+      }
+      replay_tile(tile, cycles, memo.compute_cycles);
+      _stat_memo_replays++;
+      _stat_memo_cycles += cycles;
+      return true;
+    }
+  }
+  _memo_sample_pending = true;
+  _memo_sample_validation = validation;
+  _memo_sample_signature = signature;
+  _memo_sample_issue_cycle = _core_cycle;
+  _memo_sample_layer_id = tile->layer_id;
+  return false;
+}
+
+/*
+ * Sampled layers (Model::select_sampled_tiles) run their warmup and sample
+ * tiles in full. A sample measures how long its tile holds the core until the
+ * next tile of the layer issues; once two samples exist, the remaining tiles
+ * occupy the core for the sample mean and are charged their DRAM traffic
+ * without issuing instructions.
+ */
+bool Core::issue_sampled_tile(std::unique_ptr<Tile>& tile) {
+  LayerSample& layer = _layer_samples[tile->layer_id];
+  if (_sample_pending && _sample_layer_id == tile->layer_id) {
+    LayerSample::Stratum& sampled = layer.strata[_sample_stratum];
+    double cycles = _core_cycle - _sample_issue_cycle;
+    sampled.samples++;
+    sampled.sum += cycles;
+    sampled.sum_squares += cycles * cycles;
+    sampled.compute_sum += MIN(_last_tile_compute_cycles, cycles);
+  }
+  _sample_pending = false;
+  uint64_t key = ((uint64_t)tile->accum << 32) | tile->instructions.size();
+  LayerSample::Stratum& stratum = layer.strata[key];
+  layer.optype = tile->optype;
+  layer.start_cycle = MIN(layer.start_cycle, _core_cycle);
+  for (auto& inst : tile->instructions) {
+    if (inst->opcode == Opcode::MOVIN || inst->opcode == Opcode::MOVOUT ||
+        inst->opcode == Opcode::MOVOUT_POOL)
+      layer.dram_bytes += inst->src_addrs.size() * _config.dram_req_size;
+  }
+
+  if (tile->sampling == Tile::Sampling::EXTRAPOLATE && stratum.samples >= 2) {
+    cycle_type cycles = MAX((cycle_type)std::round(stratum.sum / stratum.samples), 1);
+    replay_tile(tile, cycles, (cycle_type)std::round(stratum.compute_sum / stratum.samples));
+    layer.extrapolated_tiles++;
+    stratum.extrapolated_tiles++;
+    layer.extrapolated_cycles += cycles;
+    return true;
+  }
+  layer.detailed_tiles++;
+  if (tile->sampling != Tile::Sampling::WARMUP) {
+    _sample_pending = true;
+    _sample_issue_cycle = _core_cycle;
+    _sample_layer_id = tile->layer_id;
+    _sample_stratum = key;
+  }
+  return false;
+}
+
+/*
+ * Hold the core for cycles in place of the tile's instructions. The first
+ * compute_cycles of them are charged as compute, to the tile and the core
+ * counters (get_replay_compute_cycles), the rest as memory stall. The DRAM
+ * atoms the instructions would have moved are kept for pop_replayed_accesses().
+ */
+void Core::replay_tile(std::unique_ptr<Tile>& tile, cycle_type cycles, cycle_type compute_cycles) {
+  for (auto& inst : tile->instructions) {
+    bool write = inst->opcode == Opcode::MOVOUT || inst->opcode == Opcode::MOVOUT_POOL;
+    if (!write && inst->opcode != Opcode::MOVIN)
+      continue;
+    for (addr_type addr : inst->src_addrs)
+      _replayed_accesses.push_back({addr + inst->base_addr, write});
+  }
+  compute_cycles = MIN(compute_cycles, cycles);
+  tile->stat.cycles = cycles;
+  tile->stat.compute_cycles = compute_cycles;
+  tile->stat.memory_stall = cycles - compute_cycles;
+  tile->instructions.clear();
+  _replay_finish_cycle = _core_cycle + cycles;
+  _replay_compute_end_cycle = _core_cycle + compute_cycles;
+  _replay_tile = std::move(tile);
+}
+
+cycle_type Core::get_replay_compute_cycles(cycle_type cycles) {
+  if (!_replay_tile || _core_cycle >= _replay_compute_end_cycle)
+    return 0;
+  return MIN(cycles, _replay_compute_end_cycle - _core_cycle);
+}
+
 std::unique_ptr<Tile> Core::pop_finished_tile() {
   std::unique_ptr<Tile> result = std::make_unique<Tile>(Tile{});
   result->status = Tile::Status::EMPTY;
@@ -83,6 +262,13 @@ void Core::cycle() {
   _core_cycle++;
   _spad.cycle();
   _acc_spad.cycle();
+  if (_replay_tile && _replay_finish_cycle <= _core_cycle) {
+    _replay_tile->status = Tile::Status::FINISH;
+    _last_tile_finish_cycle = _core_cycle;
+    if (_replay_tile->sampling != Tile::Sampling::NONE)
+      _layer_samples[_replay_tile->layer_id].finish_cycle = _core_cycle;
+    _finished_tiles.push(std::move(_replay_tile));
+  }
   for (int i = 0; i < _tiles.size(); i++) {
     std::unique_ptr<Instruction>& inst = _tiles[i]->instructions.front();
     inst->spad_id = _tiles[i]->spad_id;
@@ -104,6 +290,7 @@ void Core::cycle() {
       }
       if (!buffer->check_allocated(inst->dest_addr, buffer_id) &&
           buffer->check_remain(inst->size, buffer_id)) {
+        _tiles[i]->stat.sram_writes += inst->size * _config.dram_req_size;
         _ld_inst_queue.push(std::move(inst));
         issued = true;
       } else {
@@ -117,6 +304,7 @@ void Core::cycle() {
                inst->opcode == Opcode::MOVOUT_POOL) {
       /* ST inst queue */
       if (buffer->check_hit(inst->dest_addr, buffer_id)) {
+        _tiles[i]->stat.sram_reads += inst->size * _config.dram_req_size;
         _st_inst_queue.push(std::move(inst));
         issued = true;
       }
@@ -126,6 +314,7 @@ void Core::cycle() {
         spdlog::error("null instruction!");
       }
       if(_ex_inst_queue.empty()){
+        _tiles[i]->stat.compute_cycles += get_inst_stat_cycles(inst);
         _ex_inst_queue.push(std::move(inst));
         issued = true;
       }
@@ -135,8 +324,14 @@ void Core::cycle() {
       if (_tiles[i]->instructions.empty()) {
         _tiles[i]->status = Tile::Status::FINISH;
         _tiles[i]->stat.cycles = _core_cycle - _tiles[i]->stat.start_cycle;
+        /* Pipelined instructions overlap, so their latencies may exceed the tile */
         _tiles[i]->stat.memory_stall =
-            _tiles[i]->stat.cycles - _tiles[i]->stat.compute_cycles;
+            _tiles[i]->stat.cycles > _tiles[i]->stat.compute_cycles
+                ? _tiles[i]->stat.cycles - _tiles[i]->stat.compute_cycles : 0;
+        _last_tile_finish_cycle = _core_cycle;
+        _last_tile_compute_cycles = _tiles[i]->stat.compute_cycles;
+        if (_tiles[i]->sampling != Tile::Sampling::NONE)
+          _layer_samples[_tiles[i]->layer_id].finish_cycle = _core_cycle;
         _finished_tiles.push(std::move(_tiles[i]));
         _tiles.pop_front();
       }
@@ -145,9 +340,36 @@ void Core::cycle() {
   }
 }
 
+/* Mirrors the dispatch conditions of Core::cycle() without side effects */
+bool Core::can_dispatch_instruction() {
+  for (int i = 0; i < _tiles.size(); i++) {
+    std::unique_ptr<Instruction>& inst = _tiles[i]->instructions.front();
+    if (inst->opcode == Opcode::MOVIN) {
+      return true;
+    } else if (inst->opcode == Opcode::MOVOUT ||
+               inst->opcode == Opcode::MOVOUT_POOL) {
+      if (inst->dest_addr >= ACCUM_SPAD_BASE) {
+        if (_acc_spad.check_hit(inst->dest_addr, _tiles[i]->accum_spad_id))
+          return true;
+      } else {
+        if (_spad.check_hit(inst->dest_addr, _tiles[i]->spad_id))
+          return true;
+      }
+    } else if (_ex_inst_queue.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Core::fast_forward(cycle_type cycles) {
+  _core_cycle += cycles;
+}
+
 bool Core::running() {
   bool running = false;
   running = running || _tiles.size() > 0;
+  running = running || _replay_tile != nullptr;
   running = running || !_compute_pipeline.empty();
   running = running ||
             !_vector_pipeline.empty();  // Vector unit (Might need to modify)
@@ -158,6 +380,153 @@ bool Core::running() {
   return running;
 }
 
+bool Core::is_idle() {
+  return !running() && _finished_tiles.empty() && _request_queue.empty() &&
+         _response_queue.empty();
+}
+
+void Core::set_trace(TraceWriter* writer) {
+  _trace = writer ? std::make_unique<TraceWriter::Buffer>(writer) : nullptr;
+}
+
+void Core::flush_trace() {
+  if (_trace)
+    _trace->flush();
+}
+
+void Core::checkpoint(ModelCache::Writer& writer) {
+  assert(is_idle());
+  writer.write(_core_cycle);
+  writer.write(_compute_end_cycle);
+  for (cycle_type stat : {_stat_compute_cycle, _stat_idle_cycle, _stat_memory_cycle,
+                          _accum_request_rr_cycle, _max_request_rr_cycle, _min_request_rr_cycle,
+                          _compute_memory_stall_cycle, _layernorm_stall_cycle,
+                          _softmax_stall_cycle, _add_stall_cycle, _gelu_stall_cycle,
+                          _load_memory_cycle, _store_memory_cycle, _stat_vec_compute_cycle,
+                          _stat_vec_memory_cycle, _stat_vec_idle_cycle, _stat_matmul_cycle,
+                          _stat_layernorm_cycle, _stat_add_cycle, _stat_gelu_cycle,
+                          _stat_softmax_cycle})
+    writer.write(stat);
+  writer.write(_running_layer);
+  writer.write(_current_spad);
+  writer.write(_current_acc_spad);
+  writer.write(_current_layer_id);
+  writer.write(_current_fused_op_id);
+  _spad.checkpoint(writer);
+  _acc_spad.checkpoint(writer);
+
+  writer.write<uint32_t>(_tile_memo.size());
+  for (auto& [signature, memo] : _tile_memo) {
+    writer.write(signature);
+    writer.write(memo.samples);
+    writer.write(memo.compute_samples);
+    writer.write(memo.cycles);
+    writer.write(memo.compute_cycles);
+    writer.write(memo.replays);
+  }
+  writer.write(_memo_sample_pending);
+  writer.write(_memo_sample_validation);
+  writer.write(_memo_sample_signature);
+  writer.write(_memo_sample_issue_cycle);
+  writer.write(_memo_sample_layer_id);
+  writer.write(_last_tile_finish_cycle);
+  writer.write(_last_tile_compute_cycles);
+  writer.write(_stat_memo_replays);
+  writer.write(_stat_memo_cycles);
+  writer.write(_stat_memo_read_bytes);
+  writer.write(_stat_memo_write_bytes);
+  writer.write(_stat_memo_validations);
+  writer.write(_stat_memo_error);
+  writer.write(_stat_analytical_tiles);
+  writer.write(_stat_analytical_cycles);
+  writer.write((uint32_t)_layer_samples.size());
+  for (auto& [layer_id, layer] : _layer_samples) {
+    writer.write(layer_id);
+    writer.write(layer.optype);
+    for (uint64_t value : {layer.detailed_tiles, layer.extrapolated_tiles,
+                           layer.extrapolated_cycles, layer.dram_bytes, layer.start_cycle,
+                           layer.finish_cycle})
+      writer.write(value);
+    writer.write((uint32_t)layer.strata.size());
+    for (auto& [key, stratum] : layer.strata) {
+      writer.write(key);
+      writer.write(stratum);
+    }
+  }
+  writer.write(_sample_pending);
+  writer.write(_sample_issue_cycle);
+  writer.write(_sample_layer_id);
+  writer.write(_sample_stratum);
+}
+
+void Core::restore(ModelCache::Reader& reader) {
+  _core_cycle = reader.read<cycle_type>();
+  _compute_end_cycle = reader.read<uint64_t>();
+  for (cycle_type* stat : {&_stat_compute_cycle, &_stat_idle_cycle, &_stat_memory_cycle,
+                           &_accum_request_rr_cycle, &_max_request_rr_cycle,
+                           &_min_request_rr_cycle, &_compute_memory_stall_cycle,
+                           &_layernorm_stall_cycle, &_softmax_stall_cycle, &_add_stall_cycle,
+                           &_gelu_stall_cycle, &_load_memory_cycle, &_store_memory_cycle,
+                           &_stat_vec_compute_cycle, &_stat_vec_memory_cycle,
+                           &_stat_vec_idle_cycle, &_stat_matmul_cycle, &_stat_layernorm_cycle,
+                           &_stat_add_cycle, &_stat_gelu_cycle, &_stat_softmax_cycle})
+    *stat = reader.read<cycle_type>();
+  _running_layer = reader.read<int>();
+  _current_spad = reader.read<int>();
+  _current_acc_spad = reader.read<int>();
+  _current_layer_id = reader.read<uint32_t>();
+  _current_fused_op_id = reader.read<uint32_t>();
+  _spad.restore(reader);
+  _acc_spad.restore(reader);
+
+  _tile_memo.clear();
+  uint32_t num_memos = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < num_memos; i++) {
+    TileMemo& memo = _tile_memo[reader.read<uint64_t>()];
+    memo.samples.resize(reader.read<uint32_t>());
+    for (auto& sample : memo.samples) sample = reader.read<cycle_type>();
+    memo.compute_samples.resize(reader.read<uint32_t>());
+    for (auto& sample : memo.compute_samples) sample = reader.read<cycle_type>();
+    memo.cycles = reader.read<cycle_type>();
+    memo.compute_cycles = reader.read<cycle_type>();
+    memo.replays = reader.read<uint64_t>();
+  }
+  _memo_sample_pending = reader.read<bool>();
+  _memo_sample_validation = reader.read<bool>();
+  _memo_sample_signature = reader.read<uint64_t>();
+  _memo_sample_issue_cycle = reader.read<cycle_type>();
+  _memo_sample_layer_id = reader.read<uint32_t>();
+  _last_tile_finish_cycle = reader.read<cycle_type>();
+  _last_tile_compute_cycles = reader.read<cycle_type>();
+  _stat_memo_replays = reader.read<uint64_t>();
+  _stat_memo_cycles = reader.read<cycle_type>();
+  _stat_memo_read_bytes = reader.read<uint64_t>();
+  _stat_memo_write_bytes = reader.read<uint64_t>();
+  _stat_memo_validations = reader.read<uint64_t>();
+  _stat_memo_error = reader.read<double>();
+  _stat_analytical_tiles = reader.read<uint64_t>();
+  _stat_analytical_cycles = reader.read<cycle_type>();
+  _layer_samples.clear();
+  uint32_t num_layers = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < num_layers; i++) {
+    LayerSample& layer = _layer_samples[reader.read<uint32_t>()];
+    layer.optype = reader.read_string();
+    for (uint64_t* value : {&layer.detailed_tiles, &layer.extrapolated_tiles,
+                            &layer.extrapolated_cycles, &layer.dram_bytes, &layer.start_cycle,
+                            &layer.finish_cycle})
+      *value = reader.read<uint64_t>();
+    uint32_t num_strata = reader.read<uint32_t>();
+    for (uint32_t j = 0; j < num_strata; j++) {
+      uint64_t key = reader.read<uint64_t>();
+      layer.strata[key] = reader.read<LayerSample::Stratum>();
+    }
+  }
+  _sample_pending = reader.read<bool>();
+  _sample_issue_cycle = reader.read<cycle_type>();
+  _sample_layer_id = reader.read<uint32_t>();
+  _sample_stratum = reader.read<uint64_t>();
+}
+
 bool Core::has_memory_request() { return _request_queue.size() > 0; }
 
 void Core::pop_memory_request() {
@@ -167,14 +536,31 @@ void Core::pop_memory_request() {
 
 void Core::push_memory_response(MemoryAccess *response) {
   assert(!response->request);  // can only push response
+  /* A burst response fills one spad request slot per beat */
+  size_t beats = response->size / _config.dram_req_size;
   if (response->write) {
     _waiting_write_reqs--;
   } else if (response->spad_address >= ACCUM_SPAD_BASE) {
-    _acc_spad.fill(response->spad_address, response->buffer_id);
+    _acc_spad.fill(response->spad_address, response->buffer_id, beats);
   } else {
-    _spad.fill(response->spad_address, response->buffer_id);
+    _spad.fill(response->spad_address, response->buffer_id, beats);
   }
-  delete response;
+  _access_pool.free(response);
+}
+
+uint32_t Core::get_burst_beats(AddressList::iterator& it, const AddressList::iterator& end,
+                               addr_type base_addr) {
+  /* Consume contiguous atoms from it within one burst-aligned window */
+  addr_type burst_size = _config.dram_req_size * _config.dram_burst_length;
+  addr_type start = *it + base_addr;
+  uint32_t beats = 1;
+  for (++it; it != end && beats < _config.dram_burst_length; ++it, beats++) {
+    addr_type next = *it + base_addr;
+    if (next != start + beats * _config.dram_req_size ||
+        next / burst_size != start / burst_size)
+      break;
+  }
+  return beats;
 }
 
 bool Core::can_issue_compute(std::unique_ptr<Instruction>& inst) {
@@ -196,6 +582,12 @@ bool Core::can_issue_compute(std::unique_ptr<Instruction>& inst) {
   return result;
 }
 
+cycle_type Core::get_inst_stat_cycles(std::unique_ptr<Instruction>& inst) {
+  if (inst->opcode == Opcode::GEMM || inst->opcode == Opcode::GEMM_PRELOAD)
+    return get_inst_compute_cycles(inst);
+  return 0;
+}
+
 void Core::print_stats() {
   spdlog::info(
       "Core [{}] : MatMul cycle {} LayerNorm cycle {} Softmax cycle {} "
@@ -217,4 +609,41 @@ void Core::print_stats() {
       _stat_memory_cycle, _stat_idle_cycle);
 
   spdlog::info("Core [{}] : Total cycle: {}", _id, _core_cycle);
-}
\ No newline at end of file
+  spdlog::info("Core [{}] : MemoryAccess pool high-water mark: {} (capacity {})", _id,
+               _access_pool.get_high_water_mark(), _access_pool.get_capacity());
+  if (_config.tile_memo_threshold > 0) {
+    spdlog::info(
+        "Core [{}] : Memoized tiles {} ({} cycles, DRAM read {} B write {} B) "
+        "Validated tiles {} Mean error {:.2f}%",
+        _id, _stat_memo_replays, _stat_memo_cycles, _stat_memo_read_bytes,
+        _stat_memo_write_bytes, _stat_memo_validations,
+        _stat_memo_validations ? _stat_memo_error / _stat_memo_validations * 100 : 0.0);
+  }
+  if (_stat_analytical_tiles > 0) {
+    spdlog::info("Core [{}] : Analytical tiles {} ({} cycles)", _id, _stat_analytical_tiles,
+                 _stat_analytical_cycles);
+  }
+}
+
+json Core::get_stats() {
+  json stats = {{"core_id", _id},
+                {"total_cycles", _core_cycle},
+                {"compute_cycles", _stat_compute_cycle},
+                {"memory_stall_cycles", _stat_memory_cycle},
+                {"idle_cycles", _stat_idle_cycle},
+                {"matmul_cycles", _stat_matmul_cycle},
+                {"layernorm_cycles", _stat_layernorm_cycle},
+                {"softmax_cycles", _stat_softmax_cycle},
+                {"add_cycles", _stat_add_cycle},
+                {"gelu_cycles", _stat_gelu_cycle},
+                {"matmul_stall_cycles", _compute_memory_stall_cycle},
+                {"layernorm_stall_cycles", _layernorm_stall_cycle},
+                {"softmax_stall_cycles", _softmax_stall_cycle},
+                {"add_stall_cycles", _add_stall_cycle},
+                {"gelu_stall_cycles", _gelu_stall_cycle},
+                {"load_stall_cycles", _load_memory_cycle},
+                {"store_stall_cycles", _store_memory_cycle},
+                {"memoized_tiles", _stat_memo_replays},
+                {"analytical_tiles", _stat_analytical_tiles}};
+  return stats;
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include <robin_hood.h>
 
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -8,6 +9,8 @@
 #include "SimulationConfig.h"
 #include "Sram.h"
 #include "Stat.h"
+#include "TraceWriter.h"
+#include "allocator/MemoryAccessPool.h"
 
 class Core {
  public:
@@ -25,11 +28,110 @@ class Core {
   virtual MemoryAccess* top_memory_request() { return _request_queue.front(); }
   virtual void push_memory_response(MemoryAccess* response);
   virtual void print_stats();
+  /* Counters of print_stats() as one JSON object */
+  virtual json get_stats();
   virtual cycle_type get_compute_cycles() { return _stat_compute_cycle; }
+  cycle_type get_memory_stall_cycles() { return _stat_memory_cycle; }
+  cycle_type get_idle_cycles() { return _stat_idle_cycle; }
+  /* Earliest core cycle at which this core can change state by itself */
+  virtual cycle_type get_next_event_cycle() { return _core_cycle; }
+  virtual void fast_forward(cycle_type cycles);
+  /* DRAM atom of a replayed tile, which never reaches the DRAM model */
+  struct ReplayedAccess {
+    addr_type dram_address;
+    bool write;
+  };
+  /* Accesses of tiles replayed since the last call, for the DRAM channel statistics */
+  std::vector<ReplayedAccess> pop_replayed_accesses() {
+    std::vector<ReplayedAccess> accesses;
+    accesses.swap(_replayed_accesses);
+    return accesses;
+  }
+  /* Number of cores with work when the next tile is issued */
+  void set_memory_context(uint32_t active_cores) { _memory_context = active_cores; }
+  /* True if no tile, instruction or access is held; only then can a checkpoint be taken */
+  virtual bool is_idle();
+  /* Record instruction spans to writer (nullptr: off) */
+  void set_trace(TraceWriter* writer);
+  void flush_trace();
+  virtual void checkpoint(ModelCache::Writer& writer);
+  virtual void restore(ModelCache::Reader& reader);
+
+  /* Per-layer record of sampled simulation (Tile::sampling) */
+  struct LayerSample {
+    std::string optype;
+    uint64_t detailed_tiles = 0;
+    uint64_t extrapolated_tiles = 0;
+    cycle_type extrapolated_cycles = 0;
+    /*
+     * Cycles between the issue of a sample tile and the next tile of its
+     * layer, kept apart for tiles of different shape (e.g. accumulation tiles)
+     */
+    struct Stratum {
+      uint64_t samples = 0;
+      double sum = 0;
+      double sum_squares = 0;
+      double compute_sum = 0; /* Compute cycles of the sampled tiles */
+      uint64_t extrapolated_tiles = 0;
+    };
+    std::map<uint64_t, Stratum> strata;
+    uint64_t dram_bytes = 0;
+    cycle_type start_cycle = UINT64_MAX;
+    cycle_type finish_cycle = 0;
+  };
+  const std::map<uint32_t, LayerSample>& get_layer_samples() { return _layer_samples; }
 
  protected:
   virtual bool can_issue_compute(std::unique_ptr<Instruction>& inst);
+  uint32_t get_burst_beats(AddressList::iterator& it, const AddressList::iterator& end,
+                           addr_type base_addr);
+  virtual bool can_dispatch_instruction();
   virtual cycle_type get_inst_compute_cycles(std::unique_ptr<Instruction>& inst) = 0;
+  /* Cycles an execution instruction occupies its unit, charged to its tile */
+  virtual cycle_type get_inst_stat_cycles(std::unique_ptr<Instruction>& inst);
+  bool issue_memoized_tile(std::unique_ptr<Tile>& tile);
+  bool issue_sampled_tile(std::unique_ptr<Tile>& tile);
+  /* Memoized, extrapolated and analytical tiles hold the core without instructions */
+  void replay_tile(std::unique_ptr<Tile>& tile, cycle_type cycles, cycle_type compute_cycles);
+  /* Of the next cycles, those the held replay tile counts as compute */
+  cycle_type get_replay_compute_cycles(cycle_type cycles);
+
+  /* Tile timing memoization (tile_memo_threshold > 0) */
+  struct TileMemo {
+    std::vector<cycle_type> samples;
+    std::vector<cycle_type> compute_samples; /* Compute cycles of the sampled tiles */
+    cycle_type cycles = 0;                   /* Median of samples once learned */
+    cycle_type compute_cycles = 0;           /* Median of compute_samples */
+    uint64_t replays = 0;
+  };
+  robin_hood::unordered_map<uint64_t, TileMemo> _tile_memo;
+  /* Last fully simulated tile, sampled when the next tile of its layer issues */
+  bool _memo_sample_pending = false;
+  bool _memo_sample_validation = false;
+  uint64_t _memo_sample_signature = 0;
+  cycle_type _memo_sample_issue_cycle = 0;
+  uint32_t _memo_sample_layer_id = 0;
+  std::unique_ptr<Tile> _replay_tile;
+  std::vector<ReplayedAccess> _replayed_accesses;
+  cycle_type _replay_finish_cycle = 0;
+  cycle_type _replay_compute_end_cycle = 0;
+  cycle_type _last_tile_finish_cycle = UINT64_MAX;
+  cycle_type _last_tile_compute_cycles = 0;
+  uint32_t _memory_context = 0;
+  uint64_t _stat_memo_replays = 0;
+  cycle_type _stat_memo_cycles = 0;
+  uint64_t _stat_memo_read_bytes = 0;
+  uint64_t _stat_memo_write_bytes = 0;
+  uint64_t _stat_memo_validations = 0;
+  double _stat_memo_error = 0;
+  std::map<uint32_t, LayerSample> _layer_samples;
+  bool _sample_pending = false;
+  cycle_type _sample_issue_cycle = 0;
+  uint32_t _sample_layer_id = 0;
+  uint64_t _sample_stratum = 0;
+  /* Tiles of analytically estimated layers, timed through _replay_tile */
+  uint64_t _stat_analytical_tiles = 0;
+  cycle_type _stat_analytical_cycles = 0;
 
   const uint32_t _id;
   const SimulationConfig _config;
@@ -75,6 +177,7 @@ class Core {
 
   std::queue<MemoryAccess*> _request_queue;
   std::queue<MemoryAccess*> _response_queue;
+  MemoryAccessPool _access_pool;
   uint32_t _waiting_write_reqs;
 
   int _current_spad;
@@ -83,4 +186,5 @@ class Core {
   uint32_t _current_fused_op_id;
   Sram _spad;
   Sram _acc_spad;
+  std::unique_ptr<TraceWriter::Buffer> _trace;
 };
\ No newline at end of file
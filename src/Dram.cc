@@ -3,15 +3,84 @@
 #include "helper/HelperFunctions.h"
 #include "Hashing.h"
 
-uint32_t Dram::get_channel_id(MemoryAccess* access) {
+uint32_t Dram::get_channel_id(addr_type dram_address) {
+  /* Channels interleave at burst granularity so a burst never spans channels */
+  addr_type interleave_size = _config.dram_req_size * _config.dram_burst_length;
   uint32_t channel_id;
   if (_n_ch >= 16)
-    channel_id = ipoly_hash_function((new_addr_type)access->dram_address/_config.dram_req_size, 0, _n_ch);
+    channel_id = ipoly_hash_function((new_addr_type)dram_address/interleave_size, 0, _n_ch);
   else
-    channel_id = ipoly_hash_function((new_addr_type)access->dram_address/_config.dram_req_size, 0, 16) % _n_ch;
+    channel_id = ipoly_hash_function((new_addr_type)dram_address/interleave_size, 0, 16) % _n_ch;
   return channel_id;
 }
 
+void Dram::record_replay(addr_type dram_address, bool write) {
+  ChannelStat& stat = _channel_stats[get_channel_id(dram_address)];
+  if (write)
+    stat.write_bytes += _config.dram_req_size;
+  else
+    stat.read_bytes += _config.dram_req_size;
+  stat.replayed_bytes += _config.dram_req_size;
+}
+
+/*
+ * Ramulator refreshes and closes rows on idle cycles, so they are still ticked
+ * one by one to keep its timing exact; SimpleDram skips them analytically
+ */
+void Dram::fast_forward(cycle_type cycles) {
+  assert(is_idle());
+  for (cycle_type i = 0; i < cycles; i++)
+    cycle();
+}
+
+void Dram::checkpoint(ModelCache::Writer& writer) {
+  assert(is_idle());
+  writer.write(_cycles);
+  writer.write(_channel_stats);
+}
+
+void Dram::restore(ModelCache::Reader& reader) {
+  _cycles = reader.read<cycle_type>();
+  _channel_stats.resize(reader.read<uint32_t>());
+  for (auto& stat : _channel_stats) stat = reader.read<ChannelStat>();
+}
+
+void Dram::record_response(uint32_t cid, MemoryAccess* access) {
+  ChannelStat& stat = _channel_stats[cid];
+  cycle_type latency = _cycles - access->dram_enter_cycle;
+  access->dram_finish_cycle = _cycles;
+  if (access->write) {
+    stat.writes++;
+    stat.write_bytes += access->size;
+  } else {
+    stat.reads++;
+    stat.read_bytes += access->size;
+  }
+  stat.latency_sum += latency;
+  stat.max_latency = MAX(stat.max_latency, latency);
+}
+
+json Dram::get_stats() {
+  json channels = json::array();
+  for (uint32_t ch = 0; ch < _n_ch; ch++) {
+    ChannelStat& stat = _channel_stats[ch];
+    uint64_t requests = stat.reads + stat.writes;
+    uint64_t bytes = stat.read_bytes + stat.write_bytes;
+    /* One request-sized beat per DRAM cycle is the peak of a channel */
+    double utilization = _cycles ? (double)bytes / _config.dram_req_size / _cycles : 0;
+    channels.push_back({{"channel", ch},
+                        {"reads", stat.reads},
+                        {"writes", stat.writes},
+                        {"read_bytes", stat.read_bytes},
+                        {"write_bytes", stat.write_bytes},
+                        {"replayed_bytes", stat.replayed_bytes},
+                        {"bandwidth_utilization", utilization},
+                        {"avg_latency", requests ? (double)stat.latency_sum / requests : 0},
+                        {"max_latency", stat.max_latency}});
+  }
+  return channels;
+}
+
 /* FIXME: Simple DRAM has bugs */
 SimpleDram::SimpleDram(SimulationConfig config)
     : _latency(config.dram_latency) {
@@ -20,6 +89,7 @@ SimpleDram::SimpleDram(SimulationConfig config)
   _n_ch = config.dram_channels;
   _waiting_queue.resize(_n_ch);
   _response_queue.resize(_n_ch);
+  _channel_stats.resize(_n_ch);
 }
 
 bool SimpleDram::running() { return false; }
@@ -40,11 +110,15 @@ bool SimpleDram::is_full(uint32_t cid, MemoryAccess* request) { return false; }
 
 void SimpleDram::push(uint32_t cid, MemoryAccess* request) {
   request->request = false;
+  request->dram_enter_cycle = _cycles;
+  /* Each extra beat of a burst adds one cycle of data transfer */
+  uint64_t beats = request->size / _config.dram_req_size;
   std::pair<uint64_t, MemoryAccess*> entity;
-  entity.first = MAX(_cycles + _latency, _last_finish_cycle);
+  entity.first = MAX(_cycles + _latency, _last_finish_cycle) + beats - 1;
   _last_finish_cycle = entity.first;
   entity.second = request;
   _waiting_queue[cid].push(entity);
+  _n_inflight++;
 }
 
 bool SimpleDram::is_empty(uint32_t cid) { return _response_queue[cid].empty(); }
@@ -56,7 +130,24 @@ MemoryAccess* SimpleDram::top(uint32_t cid) {
 
 void SimpleDram::pop(uint32_t cid) {
   assert(!is_empty(cid));
+  record_response(cid, _response_queue[cid].front());
   _response_queue[cid].pop();
+  _n_inflight--;
+}
+
+void SimpleDram::fast_forward(cycle_type cycles) {
+  assert(is_idle());
+  _cycles += cycles;
+}
+
+void SimpleDram::checkpoint(ModelCache::Writer& writer) {
+  Dram::checkpoint(writer);
+  writer.write(_last_finish_cycle);
+}
+
+void SimpleDram::restore(ModelCache::Reader& reader) {
+  Dram::restore(reader);
+  _last_finish_cycle = reader.read<uint64_t>();
 }
 
 DramRamulator::DramRamulator(SimulationConfig config)
@@ -67,6 +158,9 @@ DramRamulator::DramRamulator(SimulationConfig config)
   _cycles = 0;
   _total_processed_requests.resize(_n_ch);
   _processed_requests.resize(_n_ch);
+  _issuing_burst.resize(_n_ch, nullptr);
+  _issued_beats.resize(_n_ch, 0);
+  _channel_stats.resize(_n_ch);
   for (int ch = 0; ch < _n_ch; ch++) {
     _total_processed_requests[ch] = 0;
     _processed_requests[ch] = 0;
@@ -76,6 +170,8 @@ DramRamulator::DramRamulator(SimulationConfig config)
 bool DramRamulator::running() { return false; }
 
 void DramRamulator::cycle() {
+  for (uint32_t ch = 0; ch < _n_ch; ch++)
+    issue_burst_beat(ch);
   _mem->tick();
   _cycles++;
   int interval = _config.dram_print_interval? _config.dram_print_interval: INT32_MAX;
@@ -92,6 +188,9 @@ void DramRamulator::cycle() {
 }
 
 bool DramRamulator::is_full(uint32_t cid, MemoryAccess* request) {
+  /* A channel accepts no new request until the current burst is issued */
+  if (_issuing_burst[cid] != nullptr)
+    return true;
   return !_mem->isAvailable(cid, request->dram_address, request->write);
 }
 
@@ -101,13 +200,35 @@ void DramRamulator::push(uint32_t cid, MemoryAccess* request) {
   // align address
   const addr_type start_addr = target_addr - (target_addr % atomic_bytes);
   assert(start_addr == target_addr);
-  assert(request->size == atomic_bytes);
-  int count = 0;
+  assert(request->size % atomic_bytes == 0);
+  uint32_t beats = request->size / atomic_bytes;
   request->request = false;
-  _mem->push(cid, target_addr, request->write, request->core_id, request);
+  request->dram_enter_cycle = _cycles;
+  _n_inflight++;
+  if (beats == 1) {
+    _mem->push(cid, target_addr, request->write, request->core_id, request);
+    return;
+  }
+  /* Ramulator sees a burst as per-atom transactions, issued one per cycle */
+  _remaining_beats[request->id] = beats;
+  _issuing_burst[cid] = request;
+  _issued_beats[cid] = 0;
+  issue_burst_beat(cid);
 }
 
-bool DramRamulator::is_empty(uint32_t cid) { return _mem->isEmpty(cid); }
+bool DramRamulator::is_empty(uint32_t cid) {
+  /* Only the last returning beat of a burst is visible as a response */
+  while (!_remaining_beats.empty() && !_mem->isEmpty(cid)) {
+    MemoryAccess* access = (MemoryAccess*)_mem->top(cid);
+    auto it = _remaining_beats.find(access->id);
+    if (it == _remaining_beats.end() || it->second == 1)
+      break;
+    it->second--;
+    _mem->pop(cid);
+    _processed_requests[cid]++;
+  }
+  return _mem->isEmpty(cid);
+}
 
 MemoryAccess* DramRamulator::top(uint32_t cid) {
   assert(!is_empty(cid));
@@ -116,8 +237,24 @@ MemoryAccess* DramRamulator::top(uint32_t cid) {
 
 void DramRamulator::pop(uint32_t cid) {
   assert(!is_empty(cid));
+  record_response(cid, (MemoryAccess*)_mem->top(cid));
+  _remaining_beats.erase(((MemoryAccess*)_mem->top(cid))->id);
   _mem->pop(cid);
   _processed_requests[cid]++;
+  _n_inflight--;
+}
+
+void DramRamulator::issue_burst_beat(uint32_t cid) {
+  MemoryAccess* burst = _issuing_burst[cid];
+  if (burst == nullptr)
+    return;
+  addr_type addr = burst->dram_address + _issued_beats[cid] * _mem->getAtomicBytes();
+  if (!_mem->isAvailable(cid, addr, burst->write))
+    return;
+  _mem->push(cid, addr, burst->write, burst->core_id, burst);
+  _issued_beats[cid]++;
+  if (_issued_beats[cid] == burst->size / _mem->getAtomicBytes())
+    _issuing_burst[cid] = nullptr;
 }
 
 void DramRamulator::print_stat() {
@@ -131,4 +268,23 @@ void DramRamulator::print_stat() {
   float util = ((float)total_reqs / _n_ch) / _cycles * 100;
   spdlog::info("DRAM: AVG BW Util {:.2f}%", util);
   _mem->print_stats();
-}
\ No newline at end of file
+}
+
+/*
+ * Ramulator keeps its bank and refresh state internally, so a restored run
+ * continues from a fresh (precharged) memory; the request queues are empty at
+ * any checkpoint, and bandwidth statistics carry over.
+ */
+void DramRamulator::checkpoint(ModelCache::Writer& writer) {
+  Dram::checkpoint(writer);
+  writer.write(_total_processed_requests);
+  writer.write(_processed_requests);
+}
+
+void DramRamulator::restore(ModelCache::Reader& reader) {
+  Dram::restore(reader);
+  for (auto* requests : {&_total_processed_requests, &_processed_requests}) {
+    requests->resize(reader.read<uint32_t>());
+    for (auto& count : *requests) count = reader.read<uint64_t>();
+  }
+}
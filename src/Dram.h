@@ -6,6 +6,7 @@
 #include <utility>
 
 #include "Common.h"
+#include "ModelCache.h"
 #include "ramulator/Ramulator.hpp"
 
 class Dram {
@@ -18,13 +19,46 @@ class Dram {
   virtual bool is_empty(uint32_t cid) = 0;
   virtual MemoryAccess* top(uint32_t cid) = 0;
   virtual void pop(uint32_t cid) = 0;
-  uint32_t get_channel_id(MemoryAccess* request);
+  uint32_t get_channel_id(MemoryAccess* request) { return get_channel_id(request->dram_address); }
+  uint32_t get_channel_id(addr_type dram_address);
+  /* Counts an access of a replayed tile towards its channel's bytes */
+  void record_replay(addr_type dram_address, bool write);
   virtual void print_stat() {}
+  /*
+   * Per-channel requests, bytes, bandwidth utilization and latency (DRAM
+   * cycles). Bytes include replayed_bytes of tiles whose timing was replayed;
+   * requests and latency cover simulated accesses only.
+   */
+  json get_stats();
+  uint64_t get_channel_bytes(uint32_t cid) {
+    return _channel_stats[cid].read_bytes + _channel_stats[cid].write_bytes;
+  }
+  /* True if no access is held between push() and pop() */
+  virtual bool is_idle() { return _n_inflight == 0; }
+  virtual void fast_forward(cycle_type cycles);
+  /* Only an idle DRAM is checkpointed */
+  virtual void checkpoint(ModelCache::Writer& writer);
+  virtual void restore(ModelCache::Reader& reader);
 
  protected:
+  /* Called with each response as it leaves the channel */
+  void record_response(uint32_t cid, MemoryAccess* access);
+
   SimulationConfig _config;
   uint32_t _n_ch;
   cycle_type _cycles;
+  uint64_t _n_inflight = 0;
+
+  struct ChannelStat {
+    uint64_t reads = 0;
+    uint64_t writes = 0;
+    uint64_t read_bytes = 0;
+    uint64_t write_bytes = 0;
+    uint64_t replayed_bytes = 0;
+    cycle_type latency_sum = 0;
+    cycle_type max_latency = 0;
+  };
+  std::vector<ChannelStat> _channel_stats;
 };
 
 class SimpleDram : public Dram {
@@ -37,12 +71,15 @@ class SimpleDram : public Dram {
   virtual bool is_empty(uint32_t cid) override;
   virtual MemoryAccess* top(uint32_t cid) override;
   virtual void pop(uint32_t cid) override;
+  virtual void fast_forward(cycle_type cycles) override;
+  virtual void checkpoint(ModelCache::Writer& writer) override;
+  virtual void restore(ModelCache::Reader& reader) override;
 
  private:
   uint32_t _latency;
   double _bandwidth;
 
-  uint64_t _last_finish_cycle;
+  uint64_t _last_finish_cycle = 0;
   std::vector<std::queue<std::pair<addr_type, MemoryAccess*>>> _waiting_queue;
   std::vector<std::queue<MemoryAccess*>> _response_queue;
 };
@@ -59,12 +96,22 @@ class DramRamulator : public Dram {
   virtual MemoryAccess* top(uint32_t cid) override;
   virtual void pop(uint32_t cid) override;
   virtual void print_stat() override;
+  virtual void checkpoint(ModelCache::Writer& writer) override;
+  virtual void restore(ModelCache::Reader& reader) override;
 
  private:
+  void issue_burst_beat(uint32_t cid);
+
   std::unique_ptr<ram::Ramulator> _mem;
   robin_hood::unordered_flat_map<uint64_t, MemoryAccess*> _waiting_mem_access;
   std::queue<MemoryAccess*> _responses;
 
+  /* Burst being split into per-atom transactions on each channel */
+  std::vector<MemoryAccess*> _issuing_burst;
+  std::vector<uint32_t> _issued_beats;
+  /* Beats of in-flight bursts that have not returned yet, keyed by access id */
+  robin_hood::unordered_flat_map<uint32_t, uint32_t> _remaining_beats;
+
   std::vector<uint64_t> _total_processed_requests;
   std::vector<uint64_t> _processed_requests;
 };
@@ -0,0 +1,92 @@
+#include "HostProfiler.h"
+
+static thread_local HostProfiler* bound_profiler = nullptr;
+
+HostProfiler* HostProfiler::get_bound() { return bound_profiler; }
+
+HostProfiler::Scope::Scope(HostProfiler* profiler, Component component)
+    : _profiler(profiler), _component(component) {
+  if (!_profiler)
+    return;
+  _parent = _profiler->_active;
+  _profiler->_active = this;
+  _start = Clock::now();
+}
+
+HostProfiler::Scope::~Scope() {
+  if (!_profiler)
+    return;
+  double seconds = std::chrono::duration<double>(Clock::now() - _start).count();
+  _profiler->_seconds[_component] += seconds - _child_seconds;
+  if (_parent)
+    _parent->_child_seconds += seconds;
+  _profiler->_active = _parent;
+}
+
+HostProfiler::Run::Run(HostProfiler* profiler) : _profiler(profiler), _previous(bound_profiler) {
+  if (!_profiler)
+    return;
+  bound_profiler = _profiler;
+  _profiler->_running = true;
+  _profiler->_run_start = Clock::now();
+}
+
+HostProfiler::Run::~Run() {
+  if (!_profiler)
+    return;
+  _profiler->_loop_seconds = _profiler->get_loop_seconds();
+  _profiler->_running = false;
+  bound_profiler = _previous;
+}
+
+double HostProfiler::get_loop_seconds() {
+  if (!_running)
+    return _loop_seconds;
+  return _loop_seconds + std::chrono::duration<double>(Clock::now() - _run_start).count();
+}
+
+void HostProfiler::report_interval(cycle_type core_cycles) {
+  double loop_seconds = get_loop_seconds();
+  double seconds = loop_seconds - _report_loop_seconds;
+  std::string shares;
+  double other = seconds;
+  for (int component = 0; component < NUM_COMPONENTS; component++) {
+    double component_seconds = _seconds[component] - _report_seconds[component];
+    shares += fmt::format(" {} {:.1f}%", component_name((Component)component),
+                          seconds > 0 ? component_seconds / seconds * 100 : 0.0);
+    other -= component_seconds;
+    _report_seconds[component] = _seconds[component];
+  }
+  spdlog::info("Host profile [{}]: {:.0f} cycles/s,{} other {:.1f}%", core_cycles,
+               seconds > 0 ? (core_cycles - _report_cycle) / seconds : 0.0, shares,
+               seconds > 0 ? MAX(other, 0.0) / seconds * 100 : 0.0);
+  _report_cycle = core_cycles;
+  _report_loop_seconds = loop_seconds;
+}
+
+void HostProfiler::report(cycle_type core_cycles) {
+  double seconds = get_loop_seconds();
+  spdlog::info("Host profile: {} core cycles in {:.3f} s ({:.0f} cycles/s)", core_cycles,
+               seconds, seconds > 0 ? core_cycles / seconds : 0.0);
+  double other = seconds;
+  for (int component = 0; component < NUM_COMPONENTS; component++) {
+    spdlog::info("Host profile: {:<16} {:.3f} s ({:.1f}%)",
+                 component_name((Component)component), _seconds[component],
+                 seconds > 0 ? _seconds[component] / seconds * 100 : 0.0);
+    other -= _seconds[component];
+  }
+  spdlog::info("Host profile: {:<16} {:.3f} s ({:.1f}%)", "other", MAX(other, 0.0),
+               seconds > 0 ? MAX(other, 0.0) / seconds * 100 : 0.0);
+}
+
+const char* HostProfiler::component_name(Component component) {
+  switch (component) {
+    case CORE: return "core";
+    case SCHEDULER: return "scheduler";
+    case ICNT: return "icnt";
+    case DRAM: return "dram";
+    case TILE_GENERATION: return "tile_generation";
+    case MODEL_LOAD: return "model_load";
+    default: return "unknown";
+  }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+
+#include "Common.h"
+
+/*
+ * Host time spent in each simulator component (host_profile). Scopes nest:
+ * the time of an inner scope is charged to its own component only, so the
+ * components and "other" add up to the time spent in the simulation loop.
+ * A profiler is used by the thread running its simulation.
+ */
+class HostProfiler {
+ public:
+  using Clock = std::chrono::steady_clock;
+  enum Component {
+    CORE,
+    SCHEDULER,
+    ICNT,
+    DRAM,
+    TILE_GENERATION,
+    MODEL_LOAD,
+    NUM_COMPONENTS
+  };
+
+  class Scope {
+   public:
+    /* Profiler bound to this thread by Run, if any */
+    Scope(Component component) : Scope(get_bound(), component) {}
+    Scope(HostProfiler* profiler, Component component);
+    ~Scope();
+
+   private:
+    HostProfiler* _profiler;
+    Component _component;
+    Scope* _parent;
+    Clock::time_point _start;
+    double _child_seconds = 0;
+  };
+
+  /* Binds the profiler to this thread and times the simulation loop */
+  class Run {
+   public:
+    Run(HostProfiler* profiler);
+    ~Run();
+
+   private:
+    HostProfiler* _profiler;
+    HostProfiler* _previous;
+  };
+
+  /* Print throughput and component shares since the last report */
+  void report_interval(cycle_type core_cycles);
+  void report(cycle_type core_cycles);
+
+ private:
+  static HostProfiler* get_bound();
+  double get_loop_seconds();
+  static const char* component_name(Component component);
+
+  double _seconds[NUM_COMPONENTS] = {};
+  double _loop_seconds = 0;
+  bool _running = false;
+  Clock::time_point _run_start;
+  Scope* _active = nullptr;
+
+  cycle_type _report_cycle = 0;
+  double _report_loop_seconds = 0;
+  double _report_seconds[NUM_COMPONENTS] = {};
+};
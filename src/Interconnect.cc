@@ -1,10 +1,32 @@
 #include "Interconnect.h"
 #include "booksim2/Interconnect.hpp"
 #include <cmath>
+#include <condition_variable>
 #include <filesystem>
+#include <mutex>
+#include <thread>
 
 namespace fs = std::filesystem;
 
+/*
+ * Booksim2 steps its routers and clock on idle cycles, so they are still ticked
+ * one by one; SimpleInterconnect skips them analytically
+ */
+void Interconnect::fast_forward(cycle_type cycles) {
+  assert(is_idle());
+  for (cycle_type i = 0; i < cycles; i++)
+    cycle();
+}
+
+void Interconnect::checkpoint(ModelCache::Writer& writer) {
+  assert(is_idle());
+  writer.write(_cycles);
+}
+
+void Interconnect::restore(ModelCache::Reader& reader) {
+  _cycles = reader.read<uint64_t>();
+}
+
 SimpleInterconnect::SimpleInterconnect(SimulationConfig config)
   :  _latency(config.icnt_latency) {
   spdlog::info("Initialize SimpleInterconnect");
@@ -47,13 +69,18 @@ void SimpleInterconnect::cycle() {
 
 void SimpleInterconnect::push(uint32_t src, uint32_t dest, MemoryAccess* request) {
   SimpleInterconnect::Entity entity;
+  /* Write requests and read replies occupy the link for one cycle per beat */
+  uint64_t beats = 1;
+  if (request->write == request->request)
+    beats = request->size / _config.dram_req_size;
   if(_in_buffers[src].empty())
-    entity.finish_cycle =  _cycles + _latency;
+    entity.finish_cycle =  _cycles + _latency + beats - 1;
   else
-    entity.finish_cycle =  _in_buffers[src].back().finish_cycle + 1;
+    entity.finish_cycle =  _in_buffers[src].back().finish_cycle + beats;
   entity.dest = dest;
   entity.access = request;
   _in_buffers[src].push(entity);
+  _n_inflight++;
 }
 
 bool SimpleInterconnect::is_full(uint32_t nid, MemoryAccess* request) {
@@ -72,11 +99,50 @@ MemoryAccess* SimpleInterconnect::top(uint32_t nid) {
 
 void SimpleInterconnect::pop(uint32_t nid) {
   _out_buffers[nid].pop();
+  _n_inflight--;
   // spdlog::trace("PUSH {}", _cycles);
 }
 
+void SimpleInterconnect::fast_forward(cycle_type cycles) {
+  assert(is_idle());
+  _rr_start = (_rr_start + cycles) % _n_nodes;
+  _cycles += cycles;
+}
+
+void SimpleInterconnect::checkpoint(ModelCache::Writer& writer) {
+  Interconnect::checkpoint(writer);
+  writer.write(_rr_start);
+}
+
+void SimpleInterconnect::restore(ModelCache::Reader& reader) {
+  Interconnect::restore(reader);
+  _rr_start = reader.read<uint32_t>();
+}
+
+
+/*
+ * Claimed by the live Booksim2 instance. A flag rather than a held mutex, so
+ * the simulator may be destroyed on another thread than the one creating it.
+ */
+static std::mutex booksim_mutex;
+static std::condition_variable booksim_released;
+static bool booksim_in_use = false;
+static std::thread::id booksim_owner;
 
 Booksim2Interconnect::Booksim2Interconnect(SimulationConfig config) {
+  {
+    std::unique_lock<std::mutex> lock(booksim_mutex);
+    if (booksim_in_use && booksim_owner == std::this_thread::get_id()) {
+      spdlog::error("[Configuration] Booksim2 keeps global state, only one simulator may use it at a time");
+      exit(EXIT_FAILURE);
+    }
+    if (booksim_in_use) {
+      spdlog::info("Waiting for another Booksim2 simulator to finish");
+      booksim_released.wait(lock, []() { return !booksim_in_use; });
+    }
+    booksim_in_use = true;
+    booksim_owner = std::this_thread::get_id();
+  }
   _config = config;
   _n_nodes = config.num_cores + config.dram_channels;
   spdlog::info("Initialize Booksim2"); 
@@ -90,6 +156,16 @@ Booksim2Interconnect::Booksim2Interconnect(SimulationConfig config) {
   _ctrl_size = 8;
 }
 
+Booksim2Interconnect::~Booksim2Interconnect() {
+  _booksim.reset();
+  {
+    std::lock_guard<std::mutex> lock(booksim_mutex);
+    booksim_in_use = false;
+    booksim_owner = std::thread::id();
+  }
+  booksim_released.notify_one();
+}
+
 bool Booksim2Interconnect::running() {
   return false;
 }
@@ -102,6 +178,7 @@ void Booksim2Interconnect::push(uint32_t src, uint32_t dest, MemoryAccess* reque
   booksim2::Interconnect::Type type = get_booksim_type(request);
   uint32_t size = get_packet_size(request);
   _booksim->push(request, 0, 0, size, type, src, dest);
+  _n_inflight++;
 }
 
 bool Booksim2Interconnect::is_full(uint32_t nid, MemoryAccess* request) {
@@ -121,6 +198,7 @@ MemoryAccess* Booksim2Interconnect::top(uint32_t nid) {
 void Booksim2Interconnect::pop(uint32_t nid) {
   assert(!is_empty(nid));
   _booksim->pop(nid, 0);
+  _n_inflight--;
 }
 
 void Booksim2Interconnect::print_stats() {
@@ -1,6 +1,7 @@
 #ifndef INTERCONNECT_H
 #define INTERCONNECT_H
 #include "Common.h"
+#include "ModelCache.h"
 #include "booksim2/Interconnect.hpp"
 #include "helper/HelperFunctions.h"
 
@@ -15,11 +16,18 @@ class Interconnect {
   virtual MemoryAccess* top(uint32_t nid) = 0;
   virtual void pop(uint32_t nid) = 0;
   virtual void print_stats() = 0;
+  /* True if no access is held between push() and pop() */
+  virtual bool is_idle() { return _n_inflight == 0; }
+  virtual void fast_forward(cycle_type cycles);
+  /* Only an idle interconnect is checkpointed */
+  virtual void checkpoint(ModelCache::Writer& writer);
+  virtual void restore(ModelCache::Reader& reader);
 
  protected:
   SimulationConfig _config;
   uint32_t _n_nodes;
   uint64_t _cycles;
+  uint64_t _n_inflight = 0;
 };
 
 // Simple without conflict interconnect
@@ -35,11 +43,14 @@ class SimpleInterconnect : public Interconnect {
   virtual MemoryAccess* top(uint32_t nid) override;
   virtual void pop(uint32_t nid) override;
   virtual void print_stats() override {}
+  virtual void fast_forward(cycle_type cycles) override;
+  virtual void checkpoint(ModelCache::Writer& writer) override;
+  virtual void restore(ModelCache::Reader& reader) override;
 
  private:
   uint32_t _latency;
   double _bandwidth;
-  uint32_t _rr_start;
+  uint32_t _rr_start = 0;
   uint32_t _buffer_size;
 
   struct Entity {
@@ -53,9 +64,15 @@ class SimpleInterconnect : public Interconnect {
   std::vector<bool> _busy_node;
 };
 
+/*
+ * Booksim2 keeps global state, so one instance exists per process at a time.
+ * Constructing a second one waits until the first is destroyed, which may
+ * happen on any thread, and fails if the first was created on the same thread.
+ */
 class Booksim2Interconnect : public Interconnect {
  public:
   Booksim2Interconnect(SimulationConfig config);
+  ~Booksim2Interconnect();
   virtual bool running() override;
   virtual void cycle() override;
   virtual void push(uint32_t src, uint32_t dest,
@@ -14,6 +14,20 @@ MappingTable::MappingTable (SimulationConfig config) {
   _max_acc_rows = (_config.accum_spad_size KB) / (_dim * _config.precision * 2);
 }
 
+MappingTable::MappingTable(const MappingTable& other) { *this = other; }
+
+MappingTable& MappingTable::operator=(const MappingTable& other) {
+  if (this == &other)
+    return *this;
+  std::lock_guard<std::mutex> lock(other._mutex);
+  _mapping_table = other._mapping_table;
+  _config = other._config;
+  _dim = other._dim;
+  _max_spad_rows = other._max_spad_rows;
+  _max_acc_rows = other._max_acc_rows;
+  return *this;
+}
+
 MappingTable MappingTable::parse_mapping_file(
     std::string mapping_path, SimulationConfig config) {
   MappingTable map = MappingTable(config);
@@ -106,6 +120,8 @@ const Mapping& MappingTable::fallback_mapping(Mapping::LoopCounts &key) {
 }
 
 const Mapping& MappingTable::at(Mapping::LoopCounts &key) {
+  /* Operations may look up (and fill) the table from worker threads */
+  std::lock_guard<std::mutex> lock(_mutex);
   auto it = _mapping_table.find(key);
   if (it != _mapping_table.end())
     return it->second;
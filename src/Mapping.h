@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -69,6 +70,9 @@ class MappingTable {
 public:
   MappingTable ();
   MappingTable(SimulationConfig config);
+  /* Copies get their own lock */
+  MappingTable(const MappingTable& other);
+  MappingTable& operator=(const MappingTable& other);
   Mapping& operator[](const Mapping::LoopCounts &key) { return _mapping_table[key]; }
   static MappingTable parse_mapping_file(std::string mapping_path, SimulationConfig config);
   const Mapping& fallback_mapping(Mapping::LoopCounts &key);
@@ -86,6 +90,8 @@ private:
   uint32_t ceil_div(uint32_t src, uint32_t div) { return (src+div-1)/div; }
   typedef std::map<Mapping::LoopCounts, Mapping> _MappingTable;
   _MappingTable _mapping_table;
+  /* Guards _mapping_table while worker threads look up and fill it (at) */
+  mutable std::mutex _mutex;
   SimulationConfig _config;
   uint32_t _dim;
   uint32_t _max_spad_rows;
@@ -1,8 +1,17 @@
+#include <filesystem>
 #include <fstream>
+#include <random>
+#include <set>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include "Model.h"
+#include "AnalyticalModel.h"
+#include "HostProfiler.h"
+#include "ModelCache.h"
+#include "operations/CachedOperation.h"
 #include "operations/OperationFactory.h"
 
+namespace fs = std::filesystem;
+
 Model::Model(std::string onnx_path, json model_config, SimulationConfig config, std::string name, MappingTable& mapping_table) {
   _onnx_path = onnx_path;
  _name = name;
@@ -13,6 +22,8 @@ Model::Model(std::string onnx_path, json model_config, SimulationConfig config,
     _request_time = uint64_t(double(_model_config["request_time"]) * 1000 * 1000 * 1000); // Pico seconds
   else
     _request_time = 0;
+  if (_model_config.contains("slo"))
+    _slo = uint64_t(double(_model_config["slo"]) * 1000 * 1000 * 1000); // Pico seconds
   _mapping_table = mapping_table;
   if (_model_config.contains("partition_id")) {
     _partition_id = uint32_t(_model_config["partition_id"]);
@@ -20,28 +31,89 @@ Model::Model(std::string onnx_path, json model_config, SimulationConfig config,
 }
 
 Tensor* Model::get_tensor(uint32_t id) {
-  return _tensor_map[id].get();
+  /* Lookup only: called concurrently while tiles are generated */
+  if (id < _tensor_id_base || id - _tensor_id_base >= _tensors.size())
+    return nullptr;
+  return _tensors[id - _tensor_id_base].get();
 }
 
 Tensor* Model::find_tensor(std::string name) {
-  for(auto const& [key, val]: _tensor_map) {
-    if(val->_name == name) {
-      return val.get();
-    }
-  }
-  return nullptr;
+  auto it = _tensor_name_index.find(name);
+  if (it == _tensor_name_index.end())
+    return nullptr;
+  return get_tensor(it->second);
 }
 
 void Model::add_tensor(std::unique_ptr<Tensor> edge) {
-  _tensor_map[edge->get_id()] = std::move(edge);
+  uint32_t id = edge->get_id();
+  /* Ids are global, so storage starts at the first tensor of this model */
+  if (_tensors.empty())
+    _tensor_id_base = id;
+  assert(id >= _tensor_id_base);
+  if (id - _tensor_id_base >= _tensors.size())
+    _tensors.resize(id - _tensor_id_base + 1);
+  /* Same name resolves to the lowest id, as the former id-ordered scan did */
+  auto [it, inserted] = _tensor_name_index.emplace(edge->get_name(), id);
+  if (!inserted && id < it->second)
+    it->second = id;
+  _tensors[id - _tensor_id_base] = std::move(edge);
 }
 
 void Model::initialize_model() {
-  onnx::ModelProto model_proto;
-  std::vector<std::unique_ptr<Tensor>> input_tensors;
-  std::ifstream model_istream(_onnx_path);
+  _id_begin = generate_ids(0);
+  _addr_begin = allocate_address_range(0);
+  /* Hashing the ONNX and mapping files for the cache key is part of loading */
+  HostProfiler::Scope load_scope(HostProfiler::MODEL_LOAD);
+  std::string cache_path;
+  uint64_t cache_key = 0;
+  if (!_config.model_cache_dir.empty()) {
+    std::string mapping_path = fs::path(_onnx_path).replace_extension(".mapping").string();
+    cache_key = ModelCache::compute_key(_onnx_path, mapping_path, _model_config, _config);
+    cache_path = ModelCache::get_path(_config.model_cache_dir, _name, cache_key);
+  }
+
+  if (!cache_path.empty() && load_cache(cache_path, cache_key, true)) {
+    spdlog::info("Load compiled model {} from {}", _name, cache_path);
+  } else {
+    uint32_t id_begin = generate_ids(0);
+    addr_type addr_begin = allocate_address_range(0);
+    parse_model();
+    if (!cache_path.empty()) {
+      /* Continue from the stored copy so hits and misses run the same model */
+      if (save_cache(cache_path, cache_key, id_begin, addr_begin) &&
+          load_cache(cache_path, cache_key, false))
+        spdlog::info("Save compiled model {} to {}", _name, cache_path);
+      else
+        spdlog::warn("Failed to save compiled model {} to {}", _name, cache_path);
+    }
+  }
+
+  for (auto& [key, val]: _operation_map) {
+    if(val->check_executable()) {
+      spdlog::debug("runnable op, {}", val->get_optype());
+      _executable_layer.push_back(val.get());
+    } 
+  }
+  if (_config.block_detail_count > 0)
+    find_repeated_blocks();
+  /* Other layers get their tiles once they become executable */
+  initialize_tiles(_executable_layer);
+}
+
+std::shared_ptr<const onnx::ModelProto> Model::load_onnx(std::string onnx_path) {
+  auto model_proto = std::make_shared<onnx::ModelProto>();
+  std::ifstream model_istream(onnx_path);
   google::protobuf::io::IstreamInputStream zero_copy_input(&model_istream);
-  model_proto.ParseFromZeroCopyStream(&zero_copy_input) && model_istream.eof();
+  model_proto->ParseFromZeroCopyStream(&zero_copy_input) && model_istream.eof();
+  return model_proto;
+}
+
+void Model::parse_model() {
+  std::shared_ptr<const onnx::ModelProto> shared_proto =
+      _model_proto ? _model_proto : load_onnx(_onnx_path);
+  const onnx::ModelProto& model_proto = *shared_proto;
+  /* The factory config is per thread; several simulations may share it */
+  OperationFactory::initialize(_config);
   auto input = model_proto.graph().input();
 
   for (auto iter: input) {
@@ -71,17 +143,15 @@ void Model::initialize_model() {
     }
 
     auto input_tensor = std::make_unique<Tensor>(_root_node_id, input_name, input_dim, _config.precision * 16, true);
-    int id = input_tensor->get_id();
     input_tensor->set_produced();
-    _tensor_map[id] = std::move(input_tensor);
+    add_tensor(std::move(input_tensor));
   }
 
   for(auto initializer : model_proto.graph().initializer()) {
     //initialize weights
     auto tensor = std::make_unique<Tensor>(_root_node_id, initializer, _config.precision, true);
     tensor->set_produced();
-    uint32_t id = tensor->get_id();
-    _tensor_map[id] = std::move(tensor);
+    add_tensor(std::move(tensor));
   }
 
 
@@ -97,29 +167,235 @@ void Model::initialize_model() {
         }
     }
   }
+}
 
-  for (auto& [key, val]: _operation_map) {
-    if(val->check_executable()) {
-      spdlog::debug("runnable op, {}", val->get_optype());
-      _executable_layer.push_back(val.get());
-    } 
+bool Model::save_cache(std::string path, uint64_t key, uint32_t id_begin,
+                       addr_type addr_begin) {
+  ModelCache::Writer writer;
+  writer.write(ModelCache::MAGIC);
+  writer.write(ModelCache::VERSION);
+  writer.write(key);
+  writer.write(_root_node_id);
+  writer.write(id_begin);
+  writer.write(generate_ids(0));
+  writer.write(addr_begin);
+  writer.write(allocate_address_range(0));
+
+  uint32_t num_tensors = 0;
+  for (auto& tensor : _tensors)
+    num_tensors += tensor != nullptr;
+  writer.write(num_tensors);
+  for (auto& tensor : _tensors) {
+    if (tensor == nullptr)
+      continue;
+    writer.write(tensor->_id);
+    writer.write(tensor->_src_node);
+    writer.write(tensor->_produced);
+    writer.write(tensor->_name);
+    writer.write(tensor->_dims);
+    writer.write(tensor->_address);
+    writer.write(tensor->_size);
+    writer.write(tensor->_child_nodes);
+  }
+
+  /* Tile offsets are relative to the tile section and patched in once written */
+  std::vector<Operation*> ops;
+  std::vector<size_t> offset_positions;
+  writer.write<uint32_t>(_operation_map.size());
+  for (auto& [id, op] : _operation_map) {
+    writer.write(id);
+    writer.write(op->get_name());
+    writer.write(op->get_optype());
+    writer.write(op->_inputs);
+    writer.write(op->_outputs);
+    offset_positions.push_back(writer.size());
+    writer.write<uint64_t>(0);
+    ops.push_back(op.get());
+  }
+  ModelCache::File file(path);
+  file.append(writer.buffer());
+  size_t tile_section = file.size();
+
+  /* One layer per pool thread is generated and held in memory at a time */
+  size_t batch_size = _thread_pool ? _thread_pool->size() : 1;
+  for (size_t begin = 0; begin < ops.size(); begin += batch_size) {
+    size_t count = MIN(batch_size, ops.size() - begin);
+    std::vector<ModelCache::Writer> tile_writers(count);
+    auto serialize_op = [&](uint32_t index) {
+      Operation* op = ops[begin + index];
+      op->initialize_tiles(_mapping_table);
+      tile_writers[index].write_tiles(op->get_tiles());
+      op->clear_tiles();
+    };
+    {
+      HostProfiler::Scope tile_scope(HostProfiler::TILE_GENERATION);
+      if (_thread_pool && count > 1) {
+        _thread_pool->parallel_for(count, serialize_op);
+      } else {
+        for (uint32_t index = 0; index < count; index++)
+          serialize_op(index);
+      }
+    }
+    for (size_t index = 0; index < count; index++) {
+      file.patch<uint64_t>(offset_positions[begin + index], file.size() - tile_section);
+      file.append(tile_writers[index].buffer());
+    }
   }
+  return file.commit();
+}
+
+bool Model::load_cache(std::string path, uint64_t key, bool relocate) {
+  auto cache = std::make_shared<ModelCache>(path);
+  if (!cache->is_valid())
+    return false;
+  ModelCache::Reader reader(cache->data(), cache->size());
+  reader.read<uint64_t>();
+  reader.read<uint32_t>();
+  if (reader.read<uint64_t>() != key)
+    return false;
+
+  /* A hit takes fresh ids and DRAM space, a just-saved model keeps its own */
+  ModelCache::Relocation relocation;
+  relocation.old_root_id = reader.read<uint32_t>();
+  relocation.new_root_id = _root_node_id;
+  relocation.old_id_begin = reader.read<uint32_t>();
+  relocation.old_id_end = reader.read<uint32_t>();
+  addr_type addr_begin = reader.read<addr_type>();
+  addr_type addr_end = reader.read<addr_type>();
+  if (relocate) {
+    relocation.new_id_begin =
+        generate_ids(relocation.old_id_end - relocation.old_id_begin);
+    relocation.addr_offset = allocate_address_range(addr_end - addr_begin) - addr_begin;
+  } else {
+    relocation.new_id_begin = relocation.old_id_begin;
+  }
+
+  _operation_map.clear();
+  _tensors.clear();
+  _tensor_name_index.clear();
+  uint32_t num_tensors = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < num_tensors; i++) {
+    uint32_t id = relocation.id(reader.read<uint32_t>());
+    uint32_t src_node = relocation.id(reader.read<uint32_t>());
+    bool produced = reader.read<bool>();
+    std::string name = reader.read_string();
+    std::vector<uint32_t> dims(reader.read<uint32_t>());
+    for (auto& dim : dims) dim = reader.read<uint32_t>();
+    addr_type address = reader.read<addr_type>() + relocation.addr_offset;
+    uint32_t size = reader.read<uint32_t>();
+    auto tensor = std::make_unique<Tensor>(id, src_node, name, dims, address, size, produced);
+    tensor->_child_nodes = reader.read_ids(relocation);
+    add_tensor(std::move(tensor));
+  }
+
+  struct OpRecord {
+    uint32_t id;
+    std::string name;
+    std::string optype;
+    std::vector<uint32_t> inputs;
+    std::vector<uint32_t> outputs;
+    uint64_t tile_offset;
+  };
+  std::vector<OpRecord> records(reader.read<uint32_t>());
+  for (auto& record : records) {
+    record.id = relocation.id(reader.read<uint32_t>());
+    record.name = reader.read_string();
+    record.optype = reader.read_string();
+    record.inputs = reader.read_ids(relocation);
+    record.outputs = reader.read_ids(relocation);
+    record.tile_offset = reader.read<uint64_t>();
+  }
+  const char* tile_data = reader.position();
+  for (auto& record : records) {
+    auto op = std::make_unique<CachedOperation>(
+        _config, this, record.id, record.name, record.optype, cache,
+        tile_data + record.tile_offset, relocation);
+    for (uint32_t input : record.inputs) op->add_input(input);
+    for (uint32_t output : record.outputs) op->add_output(output);
+    _operation_map[record.id] = std::move(op);
+  }
+  return true;
+}
 
-  for(auto& [key, val] : _operation_map) {
-    val->initialize_tiles(_mapping_table);
+
+void Model::checkpoint(ModelCache::Writer& writer) {
+  writer.write(_id_begin);
+  writer.write(_addr_begin);
+  writer.write(_request_time);
+  writer.write(_start_time);
+  writer.write(_started);
+  std::vector<uint32_t> finished_ops;
+  std::vector<uint32_t> tiled_ops;
+  for (auto& [id, op] : _operation_map) {
+    if (op->check_finish())
+      finished_ops.push_back(id);
+    if (!op->get_tiles().empty())
+      tiled_ops.push_back(id);
+  }
+  std::vector<uint32_t> executable_ops;
+  for (auto op : _executable_layer)
+    executable_ops.push_back(op->get_id());
+  writer.write(finished_ops);
+  writer.write(executable_ops);
+  writer.write<uint32_t>(_source_cycles.size());
+  for (auto& [id, cycles] : _source_cycles) {
+    writer.write(id);
+    writer.write(cycles);
+  }
+  writer.write<uint32_t>(tiled_ops.size());
+  for (uint32_t id : tiled_ops) {
+    writer.write(id);
+    writer.write_tiles(_operation_map[id]->get_tiles());
   }
 }
 
+void Model::restore(ModelCache::Reader& reader) {
+  /* Rebuilding from the recorded ids and addresses reproduces the tensors */
+  AllocationState state = get_allocation_state();
+  AllocationState model_state = state;
+  model_state.next_id = reader.read<uint32_t>();
+  model_state.next_address = reader.read<addr_type>();
+  set_allocation_state(model_state);
+  initialize_model();
+  set_allocation_state(state);
 
-void Model::set_layer_finish(uint32_t id) {
+  _request_time = reader.read<uint64_t>();
+  _start_time = reader.read<uint64_t>();
+  _started = reader.read<bool>();
+  for (auto& [id, op] : _operation_map)
+    op->clear_tiles();
+  for (uint32_t id : reader.read_ids(ModelCache::Relocation()))
+    _operation_map[id]->set_finish();
+  _executable_layer.clear();
+  for (uint32_t id : reader.read_ids(ModelCache::Relocation()))
+    _executable_layer.push_back(_operation_map[id].get());
+  uint32_t num_sources = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < num_sources; i++) {
+    uint32_t id = reader.read<uint32_t>();
+    _source_cycles[id] = reader.read<cycle_type>();
+  }
+  uint32_t num_tiled_ops = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < num_tiled_ops; i++) {
+    uint32_t id = reader.read<uint32_t>();
+    reader.read_tiles(_operation_map[id]->get_tiles(), ModelCache::Relocation());
+  }
+}
+
+void Model::set_layer_finish(uint32_t id, cycle_type cycles) {
+  if (_source_cycles.find(id) != _source_cycles.end())
+    _source_cycles[id] = cycles;
   _operation_map[id]->set_finish();
+  /* Drop whatever the scheduler left behind of the finished layer's tiles */
+  _operation_map[id]->clear_tiles();
+  std::vector<Operation*> new_layers;
   for(auto op_id : _operation_map[id]->get_child_nodes()) {
     Operation* op = _operation_map[op_id].get();
     if(op->check_executable() && !check_exist_in_exeutable(op->get_id()))  {
       _executable_layer.push_back(op);
+      new_layers.push_back(op);
     }
   }
-
+  initialize_tiles(new_layers);
 }
 
 uint32_t Model::executable_layer_size() {
@@ -157,4 +433,195 @@ bool Model::check_exist_in_exeutable(uint32_t op_id) {
     }
   }
   return false;
+}
+
+/*
+ * Tile generation only reads shared model state, so ops run in parallel. On
+ * chain-shaped graphs few layers become executable together, so with a
+ * thread pool the layers following ops are generated ahead until there is one
+ * op per thread; they are skipped once they become executable. Layers that
+ * may replay a measured block are left to be generated on demand.
+ */
+void Model::generate_tiles(std::vector<Operation*>& ops) {
+  std::vector<Operation*> pending;
+  std::set<uint32_t> visited;
+  for (auto op : ops) {
+    visited.insert(op->get_id());
+    if (op->get_tiles().empty())
+      pending.push_back(op);
+  }
+  if (pending.empty())
+    return;
+  if (_thread_pool) {
+    std::deque<Operation*> frontier(ops.begin(), ops.end());
+    while (!frontier.empty() && pending.size() < _thread_pool->size()) {
+      Operation* op = frontier.front();
+      frontier.pop_front();
+      for (uint32_t child_id : op->get_child_nodes()) {
+        auto it = _operation_map.find(child_id);
+        if (!visited.insert(child_id).second || it == _operation_map.end() ||
+            it->second->check_finish())
+          continue;
+        Operation* child = it->second.get();
+        frontier.push_back(child);
+        if (child->get_tiles().empty() && _replay_source.find(child_id) == _replay_source.end())
+          pending.push_back(child);
+      }
+    }
+  }
+  auto initialize_op = [this, &pending](uint32_t index) {
+    pending[index]->initialize_tiles(_mapping_table);
+  };
+  if (_thread_pool && pending.size() > 1) {
+    _thread_pool->parallel_for(pending.size(), initialize_op);
+  } else {
+    for (uint32_t index = 0; index < pending.size(); index++)
+      initialize_op(index);
+  }
+}
+
+void Model::initialize_tiles(std::vector<Operation*>& ops) {
+  HostProfiler::Scope tile_scope(HostProfiler::TILE_GENERATION);
+  generate_tiles(ops);
+
+  AnalyticalModel analytical_model(_config);
+  uint32_t num_cores = _config.partiton_map[_partition_id].size();
+  for (auto op : ops) {
+    auto source = _replay_source.find(op->get_id());
+    if (source != _replay_source.end() && _source_cycles[source->second] > 0) {
+      cycle_type cycles = _source_cycles[source->second];
+      /* The measured latency has no split, so the replay counts as compute */
+      AnalyticalModel::replace_tiles(op->get_tiles(), num_cores, cycles, cycles);
+      spdlog::info("Replayed layer {} from {}: {} cycles", op->get_name(),
+                   _operation_map[source->second]->get_name(), cycles);
+      continue;
+    }
+    if (!is_analytical(op)) {
+      if (_config.sample_min_tiles > 0 && op->get_tiles().size() >= _config.sample_min_tiles)
+        select_sampled_tiles(op);
+      continue;
+    }
+    AnalyticalModel::Estimate estimate =
+        analytical_model.convert_tiles(op->get_tiles(), num_cores);
+    spdlog::info("Analytical layer {} ({}): {} tiles, {} cycles (compute {} memory {}), "
+                 "DRAM read {} B write {} B",
+                 op->get_name(), op->get_optype(), estimate.tiles, estimate.cycles,
+                 estimate.compute_cycles,
+                 estimate.memory_cycles, estimate.read_bytes, estimate.write_bytes);
+  }
+}
+
+/*
+ * Split a long layer into warm-up tiles and units of sample_interval_tiles
+ * tiles; each unit is simulated in detail with probability sample_rate, drawn
+ * from a generator seeded by the layer so runs are reproducible.
+ */
+void Model::select_sampled_tiles(Operation* op) {
+  std::mt19937_64 generator(op->get_id());
+  std::bernoulli_distribution sampled(_config.sample_rate);
+  uint32_t interval = MAX(_config.sample_interval_tiles, 1);
+  uint32_t index = 0;
+  bool sample_unit = false;
+  for (auto& tile : op->get_tiles()) {
+    if (tile->status == Tile::Status::BAR || tile->skip)
+      continue;
+    if (index < _config.sample_warmup_tiles) {
+      tile->sampling = Tile::Sampling::WARMUP;
+    } else {
+      if ((index - _config.sample_warmup_tiles) % interval == 0)
+        sample_unit = sampled(generator);
+      tile->sampling = sample_unit ? Tile::Sampling::SAMPLE : Tile::Sampling::EXTRAPOLATE;
+    }
+    index++;
+  }
+}
+
+/*
+ * Find the longest run of structurally identical consecutive blocks in graph
+ * order. Ops are compared by type, tensor shapes and the distance to the ops
+ * producing their inputs, which is the same in every instance of a block. Ops
+ * of instances past the first block_detail_count replay the cycles measured
+ * for their counterpart in the last detailed instance.
+ */
+void Model::find_repeated_blocks() {
+  std::vector<Operation*> order;
+  std::map<uint32_t, uint32_t> position;
+  for (auto& [id, op] : _operation_map) {
+    position[id] = order.size();
+    order.push_back(op.get());
+  }
+  std::vector<uint64_t> signatures;
+  for (uint32_t index = 0; index < order.size(); index++) {
+    uint64_t signature = 0xcbf29ce484222325ULL;
+    auto hash = [&signature](uint64_t value) {
+      signature = (signature ^ value) * 0x100000001b3ULL;
+    };
+    hash(std::hash<std::string>{}(order[index]->get_optype()));
+    for (auto tensors : {&order[index]->_inputs, &order[index]->_outputs}) {
+      hash(tensors->size());
+      for (uint32_t tensor_id : *tensors) {
+        Tensor* tensor = get_tensor(tensor_id);
+        if (tensor == nullptr)
+          continue;
+        for (uint32_t dim : tensor->get_dims()) hash(dim);
+        auto producer = position.find(tensor->get_src_node());
+        hash(producer != position.end() ? index - producer->second : UINT64_MAX);
+      }
+    }
+    signatures.push_back(signature);
+  }
+
+  /* A run of period p is a stretch where every op matches the one p later */
+  uint32_t n = signatures.size();
+  uint32_t best_start = 0, best_period = 0, best_count = 0;
+  for (uint32_t period = 1; period <= n / 2; period++) {
+    uint32_t run = 0;
+    for (uint32_t index = 0; index + period <= n; index++) {
+      if (index + period < n && signatures[index] == signatures[index + period]) {
+        run++;
+        continue;
+      }
+      uint32_t count = (run + period) / period;
+      if (count > 1 && count * period > best_count * best_period) {
+        best_start = index - run;
+        best_period = period;
+        best_count = count;
+      }
+      run = 0;
+    }
+  }
+  if (best_count <= _config.block_detail_count)
+    return;
+
+  uint32_t source_begin = best_start + (_config.block_detail_count - 1) * best_period;
+  for (uint32_t instance = _config.block_detail_count; instance < best_count; instance++) {
+    for (uint32_t offset = 0; offset < best_period; offset++) {
+      uint32_t source_id = order[source_begin + offset]->get_id();
+      _replay_source[order[best_start + instance * best_period + offset]->get_id()] = source_id;
+      _source_cycles[source_id] = 0;
+    }
+  }
+  spdlog::info("Model {} repeats a block of {} ops {} times from layer {}, {} simulated in detail",
+               _name, best_period, best_count, order[best_start]->get_name(),
+               _config.block_detail_count);
+}
+
+/* Per-layer lists of the model config override the operator types of the config */
+bool Model::is_analytical(Operation* op) {
+  auto listed = [this, op](const char* key) {
+    if (!_model_config.contains(key))
+      return false;
+    for (auto& name : _model_config[key])
+      if (name == op->get_name())
+        return true;
+    return false;
+  };
+  if (listed("cycle_layers"))
+    return false;
+  if (listed("analytical_layers"))
+    return true;
+  for (auto& optype : _config.analytical_ops)
+    if (optype == op->get_optype())
+      return true;
+  return false;
 }
\ No newline at end of file
@@ -6,6 +6,8 @@
 #include "operations/Operation.h"
 #include "Tensor.h"
 #include "Mapping.h"
+#include "helper/ThreadPool.h"
+#include "ModelCache.h"
 class Model {
   public:
     Model(std::string onnx_path, json model_config, SimulationConfig config, std::string name, MappingTable& map);
@@ -15,36 +17,71 @@ class Model {
     Tensor* find_tensor(std::string name);
     void add_tensor(std::unique_ptr<Tensor> tensor);
     void initialize_model();
-    void set_layer_finish(uint32_t id); 
+    /* Parsed ONNX graph, shared by models built from the same file */
+    static std::shared_ptr<const onnx::ModelProto> load_onnx(std::string onnx_path);
+    void set_model_proto(std::shared_ptr<const onnx::ModelProto> model_proto) {
+      _model_proto = model_proto;
+    }
+    void set_layer_finish(uint32_t id, cycle_type cycles);
 
     std::string get_name() { return _name; }
+    uint32_t get_root_id() { return _root_node_id; }
     uint32_t executable_layer_size();
     Operation* get_executable_tile();
     uint64_t get_request_time() const { return _request_time; }
     void set_request_time(uint64_t request_time) { _request_time=request_time; }
+    /* Latency target of the request (slo), 0 without one */
+    uint64_t get_slo() const { return _slo; }
+    uint64_t get_deadline() const { return _slo ? _request_time + _slo : UINT64_MAX; }
     uint64_t get_start_time() const { return _start_time; }
     void update_start_time(uint64_t start_time);
     bool check_finish();
     uint32_t get_partition_id() { return _partition_id; }
+    void set_thread_pool(ThreadPool* thread_pool) { _thread_pool = thread_pool; }
+    /* Layer progress of a launched model; restore() rebuilds the model first */
+    void checkpoint(ModelCache::Writer& writer);
+    void restore(ModelCache::Reader& reader);
 
   private:
     MappingTable _mapping_table;
     json _model_config;
     std::string _onnx_path;
+    std::shared_ptr<const onnx::ModelProto> _model_proto;
     std::string _name;
     uint32_t _root_node_id;
     std::map<uint32_t, std::unique_ptr<Operation>> _operation_map;
-    std::map<uint32_t, std::unique_ptr<Tensor>> _tensor_map;
+    /* Tensors are stored by id - _tensor_id_base, names are hash indexed */
+    std::vector<std::unique_ptr<Tensor>> _tensors;
+    uint32_t _tensor_id_base = 0;
+    robin_hood::unordered_map<std::string, uint32_t> _tensor_name_index;
     std::vector<Operation*> _executable_layer;
     SimulationConfig _config;
     uint32_t _partition_id = 0;
+    /* First id and DRAM address taken by initialize_model() */
+    uint32_t _id_begin = 0;
+    addr_type _addr_begin = 0;
 
     /* Number of simulating attention block */
     int nr_skip = 0; // NR_SKIP == 2 * NR_ATTEN
     uint64_t _request_time = 0;   // pico second
+    uint64_t _slo = 0;            // pico second
     uint64_t _start_time = 0;   // pico second
     bool _started = false;
+    /* Ops of replayed block instances mapped to their detailed counterpart */
+    std::map<uint32_t, uint32_t> _replay_source;
+    /* Measured cycles of the counterparts */
+    std::map<uint32_t, cycle_type> _source_cycles;
+    /* Generates tiles of executable and upcoming layers (not owned) */
+    ThreadPool* _thread_pool = nullptr;
     bool check_exist_in_exeutable(uint32_t id);
+    void generate_tiles(std::vector<Operation*>& ops);
+    void initialize_tiles(std::vector<Operation*>& ops);
+    bool is_analytical(Operation* op);
+    void select_sampled_tiles(Operation* op);
+    void find_repeated_blocks();
+    void parse_model();
+    bool save_cache(std::string path, uint64_t key, uint32_t id_begin, addr_type addr_begin);
+    bool load_cache(std::string path, uint64_t key, bool relocate);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,242 @@
+#include "ModelCache.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+/* FNV-1a, stable across builds and hosts */
+static uint64_t hash_bytes(uint64_t hash, const char* data, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    hash ^= (unsigned char)data[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+static uint64_t hash_file(uint64_t hash, std::string path) {
+  std::ifstream file(path, std::ios::binary);
+  std::vector<char> chunk(1 << 20);
+  while (file) {
+    file.read(chunk.data(), chunk.size());
+    hash = hash_bytes(hash, chunk.data(), file.gcount());
+  }
+  return hash;
+}
+
+void ModelCache::Writer::write(const AddressList& addrs) {
+  write(addrs.get_runs());
+}
+
+void ModelCache::Writer::write_tiles(std::deque<std::unique_ptr<Tile>>& tiles) {
+  write<uint32_t>(tiles.size());
+  for (auto& tile : tiles) {
+    write(tile->status);
+    write(tile->optype);
+    write(tile->layer_id);
+    write(tile->fused_op_id);
+    write(tile->batch);
+    write(tile->Q);
+    write(tile->P);
+    write(tile->M);
+    write(tile->C);
+    write(tile->S);
+    write(tile->R);
+    write(tile->accum);
+    write(tile->skip);
+    write(tile->spad_id);
+    write(tile->accum_spad_id);
+    write(tile->core_id);
+    write(tile->analytical_cycles);
+    write(tile->sampling);
+    write<uint32_t>(tile->instructions.size());
+    for (auto& inst : tile->instructions) {
+      write(inst->opcode);
+      write(inst->id);
+      write(inst->dependent_ids);
+      write(inst->dest_id);
+      write(inst->dest_addr);
+      write(inst->size);
+      write(inst->compute_size);
+      write(inst->src_addrs);
+      write(inst->spad_id);
+      write(inst->accum_spad_id);
+      write(inst->operand_id);
+      write(inst->base_addr);
+      write(inst->tile_m);
+      write(inst->tile_k);
+      write(inst->tile_n);
+      write(inst->src_from_accum);
+      write(inst->zero_init);
+    }
+  }
+}
+
+std::string ModelCache::Reader::read_string() {
+  uint32_t size = read<uint32_t>();
+  assert(_cursor + size <= _end);
+  std::string value(_cursor, size);
+  _cursor += size;
+  return value;
+}
+
+std::vector<uint32_t> ModelCache::Reader::read_ids(const Relocation& relocation) {
+  std::vector<uint32_t> ids(read<uint32_t>());
+  for (auto& id : ids) id = relocation.id(read<uint32_t>());
+  return ids;
+}
+
+AddressList ModelCache::Reader::read_addrs() {
+  AddressList addrs;
+  uint32_t num_runs = read<uint32_t>();
+  for (uint32_t i = 0; i < num_runs; i++)
+    addrs.append_run(read<AddressList::Run>());
+  return addrs;
+}
+
+void ModelCache::Reader::read_tiles(std::deque<std::unique_ptr<Tile>>& tiles,
+                                    const Relocation& relocation) {
+  uint32_t num_tiles = read<uint32_t>();
+  for (uint32_t i = 0; i < num_tiles; i++) {
+    auto tile = std::make_unique<Tile>();
+    tile->status = read<Tile::Status>();
+    tile->optype = read_string();
+    tile->layer_id = relocation.id(read<uint32_t>());
+    tile->fused_op_id = read<uint32_t>();
+    tile->batch = read<uint32_t>();
+    tile->Q = read<uint32_t>();
+    tile->P = read<uint32_t>();
+    tile->M = read<uint32_t>();
+    tile->C = read<uint32_t>();
+    tile->S = read<uint32_t>();
+    tile->R = read<uint32_t>();
+    tile->accum = read<bool>();
+    tile->skip = read<bool>();
+    tile->spad_id = read<int>();
+    tile->accum_spad_id = read<int>();
+    tile->core_id = read<int>();
+    tile->analytical_cycles = read<cycle_type>();
+    tile->sampling = read<Tile::Sampling>();
+    uint32_t num_insts = read<uint32_t>();
+    for (uint32_t j = 0; j < num_insts; j++) {
+      auto inst = std::make_unique<Instruction>();
+      inst->opcode = read<Opcode>();
+      inst->id = read_string();
+      inst->dependent_ids.resize(read<uint32_t>());
+      for (auto& id : inst->dependent_ids) id = read_string();
+      inst->dest_id = read_string();
+      inst->dest_addr = read<addr_type>();
+      inst->size = read<uint32_t>();
+      inst->compute_size = read<uint32_t>();
+      inst->src_addrs = read_addrs();
+      inst->spad_id = read<int>();
+      inst->accum_spad_id = read<int>();
+      inst->operand_id = read<uint32_t>();
+      /* DRAM addresses are issued as src_addrs + base_addr */
+      inst->base_addr = read<addr_type>() + relocation.addr_offset;
+      inst->tile_m = read<uint32_t>();
+      inst->tile_k = read<uint32_t>();
+      inst->tile_n = read<uint32_t>();
+      inst->src_from_accum = read<bool>();
+      inst->zero_init = read<bool>();
+      tile->instructions.push_back(std::move(inst));
+    }
+    tiles.push_back(std::move(tile));
+  }
+}
+
+ModelCache::ModelCache(std::string path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return;
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == 0 &&
+      (size_t)file_stat.st_size >= sizeof(MAGIC) + sizeof(VERSION)) {
+    void* data = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+      _data = (const char*)data;
+      _size = file_stat.st_size;
+    }
+  }
+  close(fd);
+  if (_data == nullptr)
+    return;
+  Reader reader(_data, _size);
+  if (reader.read<uint64_t>() != MAGIC || reader.read<uint32_t>() != VERSION) {
+    spdlog::warn("Ignoring model cache with unknown format: {}", path);
+    munmap((void*)_data, _size);
+    _data = nullptr;
+    _size = 0;
+  }
+}
+
+ModelCache::~ModelCache() {
+  if (_data != nullptr)
+    munmap((void*)_data, _size);
+}
+
+uint64_t ModelCache::compute_key(std::string onnx_path, std::string mapping_path,
+                                 json model_config, SimulationConfig config) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  hash = hash_file(hash, onnx_path);
+  hash = hash_file(hash, mapping_path);
+  /* Arrival time, placement and latency target do not change the compiled model */
+  model_config.erase("request_time");
+  model_config.erase("partition_id");
+  model_config.erase("slo");
+  std::string model_key = model_config.dump();
+  hash = hash_bytes(hash, model_key.data(), model_key.size());
+  /* Every config field read while building the graph, mappings and tiles */
+  std::string config_key = fmt::format(
+      "{} {} {} {} {} {} {} {} {} {} {}", VERSION, (int)config.core_type,
+      config.num_cores, config.core_width, config.core_height,
+      config.vector_process_bit, config.spad_size, config.accum_spad_size,
+      config.dram_req_size, config.precision, config.layout);
+  return hash_bytes(hash, config_key.data(), config_key.size());
+}
+
+std::string ModelCache::get_path(std::string cache_dir, std::string model_name,
+                                 uint64_t key) {
+  return fs::path(cache_dir).append(fmt::format("{}-{:016x}.bin", model_name, key)).string();
+}
+
+ModelCache::File::File(std::string path)
+    : _path(path), _tmp_path(fmt::format("{}.{}.tmp", path, getpid())) {
+  std::error_code error;
+  fs::create_directories(fs::path(path).parent_path(), error);
+  _file.open(_tmp_path, std::ios::binary);
+}
+
+ModelCache::File::~File() {
+  if (_committed)
+    return;
+  _file.close();
+  std::error_code error;
+  fs::remove(_tmp_path, error);
+}
+
+void ModelCache::File::append(const std::string& buffer) {
+  _file.write(buffer.data(), buffer.size());
+  _size += buffer.size();
+}
+
+bool ModelCache::File::commit() {
+  _file.close();
+  if (!_file)
+    return false;
+  std::error_code error;
+  fs::rename(_tmp_path, _path, error);
+  _committed = !error;
+  return _committed;
+}
+
+bool ModelCache::save(std::string path, const std::string& buffer) {
+  File file(path);
+  file.append(buffer);
+  return file.commit();
+}
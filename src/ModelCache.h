@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstring>
+#include <fstream>
+
+#include "Common.h"
+
+/*
+ * On-disk cache of a compiled model (tensors, operation graph and every
+ * layer's tiles). The file is mapped read-only and tiles are decoded from the
+ * mapping when a layer is pulled, so a hit skips ONNX parsing and tile
+ * generation. Ids and DRAM addresses are stored as recorded at compile time
+ * and relocated on load.
+ */
+class ModelCache {
+ public:
+  static constexpr uint64_t MAGIC = 0x45484341434d494eULL; /* "NIMCACHE" */
+  static constexpr uint32_t VERSION = 3;
+
+  /* Maps ids and addresses recorded at compile time to the current run */
+  struct Relocation {
+    uint32_t old_root_id = 0;
+    uint32_t new_root_id = 0;
+    uint32_t old_id_begin = 0;
+    uint32_t old_id_end = 0;
+    uint32_t new_id_begin = 0;
+    addr_type addr_offset = 0;
+    uint32_t id(uint32_t old_id) const {
+      if (old_id == old_root_id)
+        return new_root_id;
+      if (old_id >= old_id_begin && old_id < old_id_end)
+        return old_id - old_id_begin + new_id_begin;
+      return old_id;
+    }
+  };
+
+  class Writer {
+   public:
+    template <typename T>
+    void write(const T& value) {
+      static_assert(std::is_trivially_copyable<T>::value);
+      _buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    void write(const std::string& value) {
+      write<uint32_t>(value.size());
+      _buffer.append(value);
+    }
+    template <typename T>
+    void write(const std::vector<T>& values) {
+      write<uint32_t>(values.size());
+      for (auto& value : values) write(value);
+    }
+    void write(const AddressList& addrs);
+    void write_tiles(std::deque<std::unique_ptr<Tile>>& tiles);
+    const std::string& buffer() { return _buffer; }
+    size_t size() { return _buffer.size(); }
+
+   private:
+    std::string _buffer;
+  };
+
+  class Reader {
+   public:
+    Reader(const char* data, size_t size) : _cursor(data), _end(data + size) {}
+    template <typename T>
+    T read() {
+      T value;
+      assert(_cursor + sizeof(T) <= _end);
+      std::memcpy(&value, _cursor, sizeof(T));
+      _cursor += sizeof(T);
+      return value;
+    }
+    std::string read_string();
+    std::vector<uint32_t> read_ids(const Relocation& relocation);
+    AddressList read_addrs();
+    void read_tiles(std::deque<std::unique_ptr<Tile>>& tiles,
+                    const Relocation& relocation);
+    const char* position() { return _cursor; }
+
+   private:
+    const char* _cursor;
+    const char* _end;
+  };
+
+  /*
+   * A file streamed to a temporary path and renamed into place by commit(),
+   * so concurrent runs never map a partial file
+   */
+  class File {
+   public:
+    File(std::string path);
+    ~File();
+    File(const File&) = delete;
+    File& operator=(const File&) = delete;
+    void append(const std::string& buffer);
+    /* Overwrite a value already appended at offset */
+    template <typename T>
+    void patch(size_t offset, const T& value) {
+      static_assert(std::is_trivially_copyable<T>::value);
+      _file.seekp(offset);
+      _file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+      _file.seekp(0, std::ios::end);
+    }
+    size_t size() { return _size; }
+    bool commit();
+
+   private:
+    std::string _path;
+    std::string _tmp_path;
+    std::ofstream _file;
+    size_t _size = 0;
+    bool _committed = false;
+  };
+
+  ModelCache(std::string path);
+  ~ModelCache();
+  ModelCache(const ModelCache&) = delete;
+  ModelCache& operator=(const ModelCache&) = delete;
+  bool is_valid() { return _data != nullptr; }
+  const char* data() { return _data; }
+  size_t size() { return _size; }
+
+  static uint64_t compute_key(std::string onnx_path, std::string mapping_path,
+                              json model_config, SimulationConfig config);
+  static std::string get_path(std::string cache_dir, std::string model_name,
+                              uint64_t key);
+  static bool save(std::string path, const std::string& buffer);
+
+ private:
+  const char* _data = nullptr;
+  size_t _size = 0;
+};
@@ -0,0 +1,254 @@
+#include "Serving.h"
+
+#include <algorithm>
+#include <fstream>
+#include <list>
+#include <random>
+
+/* request_time is given in ms like in the models list */
+static uint64_t request_time_ps(const json& request) {
+  return request.contains("request_time")
+             ? uint64_t(double(request["request_time"]) * 1000 * 1000 * 1000)
+             : 0;
+}
+
+static void sort_requests(std::vector<json>& requests) {
+  std::stable_sort(requests.begin(), requests.end(), [](const json& a, const json& b) {
+    return request_time_ps(a) < request_time_ps(b);
+  });
+}
+
+std::vector<json> Serving::read_trace(std::string path, const json& models_list) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    spdlog::error("Failed to open serving trace {}", path);
+    exit(EXIT_FAILURE);
+  }
+  std::vector<json> requests;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.find_first_not_of(" \t\r") == std::string::npos)
+      continue;
+    json fields = json::parse(line);
+    json request = json::object();
+    for (auto& model_config : models_list["models"]) {
+      if (model_config["name"] == fields["name"]) {
+        request = model_config;
+        break;
+      }
+    }
+    request.update(fields);
+    requests.push_back(request);
+  }
+  sort_requests(requests);
+  spdlog::info("Serving trace {}: {} requests", path, requests.size());
+  return requests;
+}
+
+std::vector<json> Serving::poisson_trace(const json& models_list, double qps,
+                                         uint32_t num_requests, uint64_t seed) {
+  const json& models = models_list["models"];
+  std::mt19937_64 rng(seed);
+  std::exponential_distribution<double> interval(qps);
+  std::uniform_int_distribution<size_t> pick(0, models.size() - 1);
+  std::vector<json> requests;
+  double seconds = 0;
+  for (uint32_t i = 0; i < num_requests; i++) {
+    seconds += interval(rng);
+    json request = models[pick(rng)];
+    request["request_time"] = seconds * 1000;
+    requests.push_back(request);
+  }
+  spdlog::info("Serving {} Poisson arrivals at {} requests/s", num_requests, qps);
+  return requests;
+}
+
+Serving::Serving(Simulator* simulator, std::vector<json> requests, std::string model_base_path,
+                 ModelProtos model_protos)
+    : _simulator(simulator),
+      _requests(std::move(requests)),
+      _model_base_path(model_base_path),
+      _model_protos(std::move(model_protos)) {
+  sort_requests(_requests);
+}
+
+void Serving::register_request(json& request) {
+  std::string model_name = request["name"];
+  std::string onnx_path = fmt::format("{}/{}/{}.onnx", _model_base_path, model_name, model_name);
+  std::string mapping_path =
+      fmt::format("{}/{}/{}.mapping", _model_base_path, model_name, model_name);
+  auto it = _model_protos.find(model_name);
+  if (it == _model_protos.end())
+    it = _model_protos.emplace(model_name, Model::load_onnx(onnx_path)).first;
+  _simulator->register_model(request, onnx_path, mapping_path, it->second);
+}
+
+/* An idle simulator takes the next request right away and waits for its arrival */
+void Serving::run() {
+  spdlog::info("======Start Serving=====");
+  uint64_t window = STEP_CYCLES * _simulator->get_core_period();
+  size_t next = 0;
+  bool running = false;
+  while (next < _requests.size() || running) {
+    uint64_t horizon = _simulator->get_core_time() + window;
+    while (next < _requests.size() && (!running || request_time_ps(_requests[next]) <= horizon)) {
+      register_request(_requests[next++]);
+      running = true;
+    }
+    running = _simulator->step(STEP_CYCLES);
+  }
+  _simulator->print_stats();
+  print_stats();
+}
+
+void Serving::print_stats() {
+  std::vector<ModelStat> models = _simulator->get_stats().models;
+  if (models.empty())
+    return;
+  std::vector<uint64_t> latencies;
+  std::map<std::string, std::vector<uint64_t>> model_latencies;
+  uint64_t first_request = UINT64_MAX;
+  uint64_t last_finish = 0;
+  for (auto& model : models) {
+    uint64_t latency = model.finish_time - model.request_time;
+    latencies.push_back(latency);
+    model_latencies[model.name].push_back(latency);
+    first_request = MIN(first_request, model.request_time);
+    last_finish = MAX(last_finish, model.finish_time);
+  }
+  double seconds = (last_finish - first_request) / 1e12;
+  spdlog::info("Serving: {} of {} requests finished in {:.3f} ms, throughput {:.1f} requests/s",
+               models.size(), _requests.size(), seconds * 1000,
+               seconds > 0 ? models.size() / seconds : 0.0);
+  model_latencies[""] = std::move(latencies);
+  for (auto& [name, values] : model_latencies) {
+    std::sort(values.begin(), values.end());
+    spdlog::info("Serving latency{}: {} requests, p50 {:.1f} us p95 {:.1f} us p99 {:.1f} us "
+                 "max {:.1f} us",
+                 name.empty() ? "" : " [" + name + "]", values.size(),
+                 percentile(values, 50) / 1e6, percentile(values, 95) / 1e6,
+                 percentile(values, 99) / 1e6, values.back() / 1e6);
+  }
+}
+
+static uint32_t prompt_len(const json& request) {
+  return request.contains("seq_len") ? uint32_t(request["seq_len"]) : 1;
+}
+
+static uint32_t output_len(const json& request) {
+  return request.contains("output_len") ? MAX(uint32_t(request["output_len"]), 1u) : 1;
+}
+
+ContinuousBatching::ContinuousBatching(Simulator* simulator, std::vector<json> requests,
+                                       std::string model_base_path, uint32_t max_batch,
+                                       ModelProtos model_protos)
+    : Serving(simulator, std::move(requests), model_base_path, std::move(model_protos)),
+      _max_batch(MAX(max_batch, 1u)) {}
+
+/* One model of batch, padded to its longest prompt (prefill) or KV cache (decode) */
+void ContinuousBatching::register_batch(std::vector<Sequence*>& batch, bool prefill,
+                                        uint64_t time) {
+  uint32_t seq_len = 1;
+  uint32_t past_seq_len = 0;
+  for (Sequence* sequence : batch) {
+    if (prefill)
+      seq_len = MAX(seq_len, prompt_len(_requests[sequence->request]));
+    else
+      past_seq_len = MAX(past_seq_len, sequence->context);
+  }
+  json model_config = _requests[batch.front()->request];
+  model_config.erase("slo");
+  model_config["batch_size"] = batch.size();
+  model_config["seq_len"] = seq_len;
+  model_config["sequence_length"] = seq_len;
+  model_config["past_seq_len"] = past_seq_len;
+  model_config["total_seq_len"] = past_seq_len + seq_len;
+  model_config["request_time"] = time / 1e9;
+  register_request(model_config);
+}
+
+void ContinuousBatching::run() {
+  spdlog::info("======Start Continuous Batching=====");
+  std::list<Sequence> running;
+  size_t next = 0;
+  while (next < _requests.size() || !running.empty()) {
+    /* An idle simulator waits for the next arrival */
+    uint64_t now = _simulator->get_core_time();
+    if (running.empty())
+      now = MAX(now, request_time_ps(_requests[next]));
+
+    std::map<std::string, std::vector<Sequence*>> decode;
+    for (Sequence& sequence : running)
+      decode[_requests[sequence.request]["name"]].push_back(&sequence);
+    std::map<std::string, std::vector<Sequence*>> prefill;
+    while (next < _requests.size() && running.size() < _max_batch &&
+           request_time_ps(_requests[next]) <= now) {
+      running.push_back(Sequence{.request = next, .context = 0, .tokens = 0});
+      prefill[_requests[next++]["name"]].push_back(&running.back());
+    }
+    for (auto& [name, batch] : decode)
+      register_batch(batch, false, now);
+    for (auto& [name, batch] : prefill)
+      register_batch(batch, true, now);
+    while (_simulator->step(STEP_CYCLES))
+      ;
+
+    uint64_t finish_time = _simulator->get_core_time();
+    _iterations++;
+    _batched_sequences += running.size();
+    for (auto it = running.begin(); it != running.end();) {
+      const json& request = _requests[it->request];
+      it->context = it->tokens ? it->context + 1 : prompt_len(request);
+      if (it->tokens++ == 0)
+        it->first_token_time = finish_time;
+      if (it->tokens < output_len(request)) {
+        ++it;
+        continue;
+      }
+      _results.push_back(Result{.name = request["name"],
+                                .request_time = request_time_ps(request),
+                                .first_token_time = it->first_token_time,
+                                .finish_time = finish_time,
+                                .tokens = it->tokens});
+      it = running.erase(it);
+    }
+  }
+  _simulator->print_stats();
+  print_stats();
+}
+
+void ContinuousBatching::print_stats() {
+  if (_results.empty())
+    return;
+  std::vector<uint64_t> ttft;
+  std::vector<uint64_t> tpot;
+  std::vector<uint64_t> latencies;
+  uint64_t tokens = 0;
+  uint64_t first_request = UINT64_MAX;
+  uint64_t last_finish = 0;
+  for (auto& result : _results) {
+    ttft.push_back(result.first_token_time - result.request_time);
+    if (result.tokens > 1)
+      tpot.push_back((result.finish_time - result.first_token_time) / (result.tokens - 1));
+    latencies.push_back(result.finish_time - result.request_time);
+    tokens += result.tokens;
+    first_request = MIN(first_request, result.request_time);
+    last_finish = MAX(last_finish, result.finish_time);
+  }
+  double seconds = (last_finish - first_request) / 1e12;
+  spdlog::info("Continuous batching: {} requests in {} iterations (mean batch {:.2f}), "
+               "{} tokens in {:.3f} ms, {:.1f} tokens/s, {:.1f} requests/s",
+               _results.size(), _iterations, double(_batched_sequences) / _iterations, tokens,
+               seconds * 1000, seconds > 0 ? tokens / seconds : 0.0,
+               seconds > 0 ? _results.size() / seconds : 0.0);
+  std::vector<std::pair<std::string, std::vector<uint64_t>*>> metrics = {
+      {"time to first token", &ttft}, {"time per output token", &tpot}, {"latency", &latencies}};
+  for (auto& [metric, values] : metrics) {
+    if (values->empty())
+      continue;
+    std::sort(values->begin(), values->end());
+    spdlog::info("Continuous batching {}: p50 {:.1f} us p95 {:.1f} us p99 {:.1f} us max {:.1f} us",
+                 metric, percentile(*values, 50) / 1e6, percentile(*values, 95) / 1e6,
+                 percentile(*values, 99) / 1e6, values->back() / 1e6);
+  }
+}
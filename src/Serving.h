@@ -0,0 +1,93 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Simulator.h"
+
+using ModelProtos = std::map<std::string, std::shared_ptr<const onnx::ModelProto>>;
+
+/*
+ * Serving mode: requests of an arrival trace are registered with the
+ * simulator shortly before simulated time reaches their request_time, so only
+ * requests in flight hold built models. Requests are models list entries; at
+ * the end throughput and latency percentiles over all requests and per model
+ * name are reported.
+ */
+class Serving {
+ public:
+  /* Simulated core cycles between registrations; arrivals within the next window are registered */
+  static constexpr cycle_type STEP_CYCLES = 10000;
+
+  /*
+   * One request per JSONL line, e.g. {"name": "bert", "request_time": 0.5,
+   * "batch_size": 1, "seq_len": 128}. Fields override the models list entry
+   * of the same name, which supplies the remaining dimensions.
+   */
+  static std::vector<json> read_trace(std::string path, const json& models_list);
+  /* num_requests Poisson arrivals at qps requests per simulated second,
+   * each drawing an entry of the models list uniformly */
+  static std::vector<json> poisson_trace(const json& models_list, double qps,
+                                         uint32_t num_requests, uint64_t seed);
+
+  /* Models not in model_protos are parsed from model_base_path on first use */
+  Serving(Simulator* simulator, std::vector<json> requests, std::string model_base_path,
+          ModelProtos model_protos = {});
+  virtual ~Serving() = default;
+  virtual void run();
+  virtual void print_stats();
+
+ protected:
+  void register_request(json& request);
+  Simulator* _simulator;
+  std::vector<json> _requests; /* By request_time */
+  std::string _model_base_path;
+  ModelProtos _model_protos;
+};
+
+/*
+ * Continuous (iteration-level) batching of generation requests. Each
+ * iteration registers one prefill model for the requests admitted at its
+ * start and one decode model for the running batch, per model name, built
+ * from the same ONNX graph with batch_size, seq_len and past_seq_len of that
+ * batch so their Attention and GemmWS tiles follow the batch. At the
+ * iteration boundary finished requests retire and requests that arrived
+ * meanwhile are admitted, up to max_batch in flight.
+ *
+ * A request's seq_len is its prompt length and output_len (default 1) the
+ * tokens it generates, the first one by its prefill. Attention takes one KV
+ * length per batch, so a batch is padded to its longest sequence.
+ */
+class ContinuousBatching : public Serving {
+ public:
+  struct Result {
+    std::string name;
+    uint64_t request_time;     /* ps */
+    uint64_t first_token_time; /* ps */
+    uint64_t finish_time;      /* ps */
+    uint32_t tokens;
+  };
+
+  ContinuousBatching(Simulator* simulator, std::vector<json> requests,
+                     std::string model_base_path, uint32_t max_batch,
+                     ModelProtos model_protos = {});
+  void run() override;
+  void print_stats() override;
+  const std::vector<Result>& get_results() { return _results; }
+  uint32_t get_iterations() { return _iterations; }
+
+ private:
+  struct Sequence {
+    size_t request;   /* Index in _requests */
+    uint32_t context; /* Tokens in the KV cache */
+    uint32_t tokens;  /* Generated tokens */
+    uint64_t first_token_time;
+  };
+  void register_batch(std::vector<Sequence*>& batch, bool prefill, uint64_t time);
+  uint32_t _max_batch;
+  uint32_t _iterations = 0;
+  uint64_t _batched_sequences = 0; /* Summed over iterations */
+  std::vector<Result> _results;    /* By finish time */
+};
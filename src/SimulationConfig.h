@@ -2,6 +2,7 @@
 
 #include <nlohmann/json.hpp>
 #include <string>
+#include <vector>
 
 using json = nlohmann::json;
 
@@ -43,8 +44,10 @@ struct SimulationConfig {
   uint32_t dram_channels;
   uint32_t dram_req_size;
   uint32_t dram_latency;
-  uint32_t dram_print_interval;
+  uint32_t dram_print_interval = 0;
   std::string dram_config_path;
+  /* Max dram_req_size beats coalesced into one request (1: no bursts) */
+  uint32_t dram_burst_length = 1;
 
   /* ICNT config */
   IcntType icnt_type;
@@ -54,11 +57,54 @@ struct SimulationConfig {
 
   /* Sheduler config */
   std::string scheduler_type;
+  /* Layers of a model in flight at once with the layer_parallel scheduler */
+  uint32_t max_active_layers = 4;
+  /* Idle cores take unstarted accumulation chains from the most loaded core */
+  bool work_stealing = false;
 
   /* Other configs */
   uint32_t precision;
   std::string layout;
 
+  /* Skip idle cycles when every component is waiting for a known event */
+  bool fast_forward = false;
+  /* Host threads stepping the cores (1: serial) */
+  uint32_t num_threads = 1;
+  /* Directory of compiled model caches (empty: disabled) */
+  std::string model_cache_dir;
+  /* Full simulations of a tile signature before its latency is replayed (0: off) */
+  uint32_t tile_memo_threshold = 0;
+  /* Every n-th replayable tile is simulated in full to measure error (0: never) */
+  uint32_t tile_memo_validate_interval = 16;
+  /* Operator types charged an analytical latency instead of being simulated */
+  std::vector<std::string> analytical_ops;
+  /* Layers with at least sample_min_tiles tiles are simulated by sampling (0: off) */
+  uint32_t sample_min_tiles = 0;
+  uint32_t sample_warmup_tiles = 16;
+  /* Consecutive tiles per sampling unit, each simulated in detail with sample_rate */
+  uint32_t sample_interval_tiles = 4;
+  double sample_rate = 0.1;
+  /*
+   * Instances of a repeated block (e.g. transformer layers) simulated in
+   * detail; later instances replay their measured layer cycles (0: off)
+   */
+  uint32_t block_detail_count = 0;
+  /* Core cycles between simulation checkpoints (0: off) */
+  uint64_t checkpoint_interval = 0;
+  std::string checkpoint_dir = "checkpoints";
+  /* Structured statistics written at the end of a run: .json, or .csv per section ("": off) */
+  std::string stats_path = "";
+  /* Include every tile in the structured statistics */
+  bool stats_tiles = false;
+  /* Chrome trace timeline of tiles, instructions, layers and DRAM bandwidth ("": off) */
+  std::string trace_path = "";
+  /* Core cycles between DRAM bandwidth samples of the trace */
+  uint64_t trace_interval = 1000;
+  /* Report host time per component and simulated cycles per host second */
+  bool host_profile = false;
+  /* Core cycles between host profile reports (0: only at the end) */
+  uint64_t host_profile_interval = 1000000;
+
   /*
    * This map stores the partition information: <partition_id, core_id>
    *
@@ -1,6 +1,10 @@
 #include "Simulator.h"
 
+#include <algorithm>
+#include <cmath>
 #include <filesystem>
+#include <fstream>
+#include <map>
 #include <string>
 
 #include "SystolicOS.h"
@@ -8,8 +12,15 @@
 
 namespace fs = std::filesystem;
 
+static constexpr uint64_t CHECKPOINT_MAGIC = 0x54504b434d494e4fULL; /* "ONIMCKPT" */
+static constexpr uint32_t CHECKPOINT_VERSION = 6;
+
 Simulator::Simulator(SimulationConfig config)
-    : _config(config), _core_cycles(0) {
+    : _config(config),
+      _context(std::make_unique<AllocationContext>()),
+      _core_cycles(0),
+      _fast_forward_cycles(0) {
+  AllocationScope scope(_context.get());
   // Create dram object
   _core_period = 1000000 / (config.core_freq);
   _icnt_period = 1000000 / (config.icnt_freq);
@@ -44,6 +55,9 @@ Simulator::Simulator(SimulationConfig config)
     spdlog::error("[Configuration] {} Invalid interconnect type...!");
     exit(EXIT_FAILURE);
   }
+  if (config.fast_forward &&
+      (config.dram_type != DramType::SIMPLE || config.icnt_type != IcntType::SIMPLE))
+    spdlog::info("Fast-forward skips core cycles only; Ramulator and Booksim2 still tick every cycle");
 
   // Create core objects
   _cores.resize(config.num_cores);
@@ -60,6 +74,34 @@ Simulator::Simulator(SimulationConfig config)
     }
   }
   
+  /* Cores only touch their own state in Core::cycle(), so they can be stepped
+   * in parallel while scheduler and ICNT interaction stays serial. Models
+   * also use the pool to generate tiles of newly executable layers. */
+  if (config.num_threads > 1) {
+    spdlog::info("Core simulation threads: {}", MIN(config.num_threads, _n_cores));
+    /* Workers allocate ids and addresses of the simulation creating them */
+    AllocationContext* context = get_allocation_context();
+    _thread_pool = std::make_unique<ThreadPool>(
+        MIN(config.num_threads, _n_cores),
+        [context]() { bind_allocation_context(context); });
+  }
+  _core_cycle_func = [this](uint32_t core_id) { _cores[core_id]->cycle(); };
+  _core_running_func = [this](uint32_t core_id) { return _cores[core_id]->running(); };
+
+  if (config.host_profile) {
+    _profiler = std::make_unique<HostProfiler>();
+    _next_profile_cycle = config.host_profile_interval;
+  }
+
+  if (!config.trace_path.empty()) {
+    _trace_writer = std::make_unique<TraceWriter>(config.trace_path, _n_cores);
+    _trace = std::make_unique<TraceWriter::Buffer>(_trace_writer.get());
+    for (auto& core : _cores)
+      core->set_trace(_trace_writer.get());
+    _trace_dram_bytes.resize(_n_memories, 0);
+    _next_trace_cycle = config.trace_interval;
+  }
+
   if (config.scheduler_type == "simple") {
     _scheduler = std::make_unique<Scheduler>(_config, &_core_cycles, &_core_time);
   } else if (config.scheduler_type == "partition_cpu") {
@@ -68,8 +110,13 @@ Simulator::Simulator(SimulationConfig config)
   } else if (config.scheduler_type == "time_multiplex") {
     _scheduler =
         std::make_unique<TimeMultiplexScheduler>(_config, &_core_cycles, &_core_time);
+  } else if (config.scheduler_type == "edf") {
+    _scheduler = std::make_unique<DeadlineScheduler>(_config, &_core_cycles, &_core_time);
   } else if (config.scheduler_type == "spatial_split") {
     _scheduler = std::make_unique<HalfSplitScheduler>(_config, &_core_cycles, &_core_time);
+  } else if (config.scheduler_type == "layer_parallel") {
+    _scheduler =
+        std::make_unique<LayerParallelScheduler>(_config, &_core_cycles, &_core_time);
   } else {
     spdlog::error("[Configuration] {} is invalid scheduler type...!", config.scheduler_type);
     exit(EXIT_FAILURE);
@@ -77,11 +124,276 @@ Simulator::Simulator(SimulationConfig config)
 
   /* Create heap */
   std::make_heap(_models.begin(), _models.end(), CompareModel());
+  _next_checkpoint_cycle = config.checkpoint_interval;
+  /* Only counters of the DRAM are saved, and Ramulator's bank, row and refresh state is not */
+  if (config.checkpoint_interval > 0 && config.dram_type == DramType::RAMULATOR) {
+    spdlog::error("[Configuration] checkpoint_interval is not supported with Ramulator");
+    exit(EXIT_FAILURE);
+  }
+  if (config.checkpoint_interval > 0)
+    spdlog::info("Checkpoints drain the cores every {} cycles, which changes the timing of "
+                 "this run", config.checkpoint_interval);
+}
+
+std::unique_ptr<Simulator> Simulator::create(json config) {
+  return std::make_unique<Simulator>(initialize_config(config));
+}
+
+void Simulator::register_model(json model_config, std::string onnx_path,
+                               std::string mapping_path,
+                               std::shared_ptr<const onnx::ModelProto> model_proto) {
+  AllocationScope scope(_context.get());
+  std::string model_name = model_config["name"];
+  MappingTable mapping_table = MappingTable::parse_mapping_file(mapping_path, _config);
+  auto model = std::make_unique<Model>(onnx_path, model_config, _config, model_name, mapping_table);
+  if (model_proto != nullptr)
+    model->set_model_proto(model_proto);
+  spdlog::info("Register model: {}", model_name);
+  register_model(std::move(model));
 }
 
 void Simulator::run_simulator() {
   spdlog::info("======Start Simulation=====");
-  cycle();
+  cycle(UINT64_MAX);
+  print_stats();
+}
+
+bool Simulator::step(cycle_type core_cycles) {
+  cycle(core_cycles < UINT64_MAX - _core_cycles ? _core_cycles + core_cycles : UINT64_MAX);
+  return running();
+}
+
+Simulator::Stats Simulator::get_stats() {
+  Stats stats = {.core_cycles = _core_cycles, .core_time = _core_time, .finished = !running()};
+  for (int core_id = 0; core_id < _n_cores; core_id++) {
+    Core* core = _cores[core_id].get();
+    stats.cores.push_back(CoreResult{.compute_cycles = core->get_compute_cycles(),
+                                     .memory_stall_cycles = core->get_memory_stall_cycles(),
+                                     .idle_cycles = core->get_idle_cycles(),
+                                     .stolen_tiles = _scheduler->get_stolen_tiles(core_id)});
+  }
+  for (auto& [id, layer] : _scheduler->get_layer_stats())
+    stats.layers.push_back(LayerResult{.name = layer.name,
+                                       .start_cycle = layer.start_cycle,
+                                       .finish_cycle = layer.finish_cycle});
+  std::sort(stats.layers.begin(), stats.layers.end(),
+            [](const LayerResult& a, const LayerResult& b) {
+              return a.finish_cycle < b.finish_cycle;
+            });
+  stats.models = get_model_stats();
+  return stats;
+}
+
+/* Layer span once its last tile finished */
+void Simulator::trace_layer(uint32_t layer_id) {
+  auto& layers = _scheduler->get_layer_stats();
+  auto it = layers.find(layer_id);
+  if (it == layers.end() || it->second.finish_cycle != _core_cycles)
+    return;
+  const Scheduler::LayerStat& layer = it->second;
+  _trace->complete(TraceWriter::SCHEDULER_PID, layer.request_id, layer.name, layer.start_cycle,
+                   layer.finish_cycle - layer.start_cycle,
+                   fmt::format("{{\"layer_id\":{},\"optype\":\"{}\",\"tiles\":{}}}",
+                               layer_id, TraceWriter::escape(layer.optype), layer.total_tiles));
+}
+
+/* Bandwidth utilization of each DRAM channel since the previous sample */
+void Simulator::trace_dram() {
+  cycle_type interval = _config.trace_interval + _core_cycles - _next_trace_cycle;
+  double peak_bytes = (double)interval * _core_period / _dram_period * _config.dram_req_size;
+  std::vector<std::pair<std::string, double>> values;
+  double total = 0;
+  for (uint32_t ch = 0; ch < _n_memories; ch++) {
+    uint64_t bytes = _dram->get_channel_bytes(ch);
+    double utilization = (bytes - _trace_dram_bytes[ch]) / peak_bytes * 100;
+    values.emplace_back(fmt::format("ch{}", ch), utilization);
+    total += utilization;
+    _trace_dram_bytes[ch] = bytes;
+  }
+  _trace->counter(TraceWriter::DRAM_PID, "Bandwidth utilization (%)", _core_cycles, values);
+  _trace->counter(TraceWriter::DRAM_PID, "Average bandwidth utilization (%)", _core_cycles,
+                  {{"avg", total / _n_memories}});
+  _next_trace_cycle = _core_cycles + _config.trace_interval;
+}
+
+void Simulator::record_tile(Tile& tile) {
+  OpStat& op = _op_stats[tile.layer_id];
+  op.tiles++;
+  op.compute_cycles += tile.stat.compute_cycles;
+  op.memory_stall += tile.stat.memory_stall;
+  op.sram_reads += tile.stat.sram_reads;
+  op.sram_writes += tile.stat.sram_writes;
+  if (_config.stats_tiles)
+    op.tile_stats.push_back(tile.stat);
+}
+
+/* Finished models with the layers the scheduler finished for each request */
+std::vector<ModelStat> Simulator::get_model_stats() {
+  std::vector<ModelStat> models = _scheduler->get_model_stats();
+  std::map<uint32_t, std::vector<OpStat>> request_ops;
+  for (auto& [id, layer] : _scheduler->get_layer_stats()) {
+    auto it = _op_stats.find(id);
+    OpStat op = it != _op_stats.end() ? it->second : OpStat{};
+    op.id = id;
+    op.name = layer.name;
+    op.optype = layer.optype;
+    op.start_cycle = layer.start_cycle;
+    op.finish_cycle = layer.finish_cycle;
+    op.op_cycles = layer.finish_cycle - layer.start_cycle;
+    request_ops[layer.request_id].push_back(std::move(op));
+  }
+  for (auto& model : models) {
+    model.op_stats = std::move(request_ops[model.request_id]);
+    std::sort(model.op_stats.begin(), model.op_stats.end(),
+              [](const OpStat& a, const OpStat& b) { return a.finish_cycle < b.finish_cycle; });
+  }
+  return models;
+}
+
+/*
+ * Finished requests grouped by model name (tenant): SLO attainment over the
+ * requests with an slo and latency from request to finish over all of them.
+ */
+json Simulator::get_tenant_stats() {
+  std::map<std::string, std::vector<ModelStat>> tenant_models;
+  for (auto& model : _scheduler->get_model_stats())
+    tenant_models[model.name].push_back(model);
+  json tenants = json::array();
+  for (auto& [name, models] : tenant_models) {
+    std::vector<uint64_t> latencies;
+    uint64_t slo_requests = 0;
+    uint64_t slo_met = 0;
+    for (auto& model : models) {
+      uint64_t latency = model.finish_time - model.request_time;
+      latencies.push_back(latency);
+      if (model.slo) {
+        slo_requests++;
+        slo_met += latency <= model.slo;
+      }
+    }
+    std::sort(latencies.begin(), latencies.end());
+    tenants.push_back({{"name", name},
+                       {"requests", models.size()},
+                       {"slo_requests", slo_requests},
+                       {"slo_met", slo_met},
+                       {"slo_attainment", slo_requests ? (double)slo_met / slo_requests : 1.0},
+                       {"latency_p50_ps", percentile(latencies, 50)},
+                       {"latency_p95_ps", percentile(latencies, 95)},
+                       {"latency_p99_ps", percentile(latencies, 99)},
+                       {"latency_max_ps", latencies.back()}});
+  }
+  return tenants;
+}
+
+/* RFC 4180: fields holding a comma, quote or line break are quoted, inner quotes doubled */
+static std::string csv_field(const std::string& value) {
+  if (value.find_first_of(",\"\r\n") == std::string::npos)
+    return value;
+  std::string quoted = "\"";
+  for (char c : value)
+    quoted += (c == '"') ? std::string("\"\"") : std::string(1, c);
+  return quoted + "\"";
+}
+
+static void write_csv(std::string path, const json& rows) {
+  std::ofstream file(path);
+  if (rows.empty())
+    return;
+  bool first = true;
+  for (auto& [key, value] : rows[0].items()) {
+    file << (first ? "" : ",") << csv_field(key);
+    first = false;
+  }
+  file << std::endl;
+  for (auto& row : rows) {
+    first = true;
+    for (auto& [key, value] : row.items()) {
+      file << (first ? "" : ",")
+           << csv_field(value.is_string() ? value.get<std::string>() : value.dump());
+      first = false;
+    }
+    file << std::endl;
+  }
+}
+
+/*
+ * A .json path gets one document; any other path is the stem of
+ * <stem>_cores.csv, <stem>_layers.csv, <stem>_models.csv, <stem>_tenants.csv,
+ * <stem>_dram.csv and, with stats_tiles, <stem>_tiles.csv.
+ */
+void Simulator::write_stats(std::string path) {
+  json cores = json::array();
+  for (int core_id = 0; core_id < _n_cores; core_id++) {
+    cores.push_back(_cores[core_id]->get_stats());
+    cores.back()["stolen_tiles"] = _scheduler->get_stolen_tiles(core_id);
+  }
+  json models = json::array();
+  json layers = json::array();
+  json tiles = json::array();
+  for (auto& model : get_model_stats()) {
+    models.push_back({{"request_id", model.request_id},
+                      {"name", model.name},
+                      {"request_time_ps", model.request_time},
+                      {"start_time_ps", model.start_time},
+                      {"finish_time_ps", model.finish_time},
+                      {"finish_cycle", model.finish_cycle},
+                      {"total_cycles", model.total_cycles},
+                      {"slo_ps", model.slo},
+                      {"layers", model.op_stats.size()}});
+    for (auto& op : model.op_stats) {
+      layers.push_back({{"request_id", model.request_id},
+                        {"model", model.name},
+                        {"layer_id", op.id},
+                        {"name", op.name},
+                        {"optype", op.optype},
+                        {"start_cycle", op.start_cycle},
+                        {"finish_cycle", op.finish_cycle},
+                        {"cycles", op.op_cycles},
+                        {"tiles", op.tiles},
+                        {"compute_cycles", op.compute_cycles},
+                        {"memory_stall_cycles", op.memory_stall},
+                        {"sram_read_bytes", op.sram_reads},
+                        {"sram_write_bytes", op.sram_writes}});
+      for (auto& tile : op.tile_stats)
+        tiles.push_back({{"layer_id", op.id},
+                         {"core_id", tile.core_id},
+                         {"start_cycle", tile.start_cycle},
+                         {"cycles", tile.cycles},
+                         {"compute_cycles", tile.compute_cycles},
+                         {"memory_stall_cycles", tile.memory_stall},
+                         {"sram_read_bytes", tile.sram_reads},
+                         {"sram_write_bytes", tile.sram_writes}});
+    }
+  }
+  json channels = _dram->get_stats();
+
+  fs::path stats_path(path);
+  if (stats_path.has_parent_path())
+    fs::create_directories(stats_path.parent_path());
+  if (stats_path.extension() == ".json") {
+    json stats = {{"core_cycles", _core_cycles},
+                  {"core_time_ps", _core_time},
+                  {"load_imbalance", get_load_imbalance()},
+                  {"cores", cores},
+                  {"models", models},
+                  {"tenants", get_tenant_stats()},
+                  {"layers", layers},
+                  {"dram_channels", channels}};
+    if (_config.stats_tiles)
+      stats["tiles"] = tiles;
+    std::ofstream file(path);
+    file << stats.dump(2) << std::endl;
+  } else {
+    std::string stem = stats_path.replace_extension().string();
+    write_csv(stem + "_cores.csv", cores);
+    write_csv(stem + "_models.csv", models);
+    write_csv(stem + "_tenants.csv", get_tenant_stats());
+    write_csv(stem + "_layers.csv", layers);
+    write_csv(stem + "_dram.csv", channels);
+    if (_config.stats_tiles)
+      write_csv(stem + "_tiles.csv", tiles);
+  }
+  spdlog::info("Statistics written to {}", path);
 }
 
 void Simulator::handle_model() {
@@ -90,53 +402,97 @@ void Simulator::handle_model() {
     std::pop_heap(_models.begin(), _models.end(), CompareModel());
     _models.pop_back();
 
+    launch_model->set_thread_pool(_thread_pool.get());
     launch_model->initialize_model();
-    launch_model->set_request_time(_core_time);
+    _launched_models++;
+    /* request_time stays the arrival, so latency includes any wait for the launch */
     spdlog::info("Schedule model: {} at {} us", launch_model->get_name(), _core_time / (1000000));
     _scheduler->schedule_model(std::move(launch_model), 1);
   }
 }
 
-void Simulator::cycle() {
-  OpStat op_stat;
-  ModelStat model_stat;
+void Simulator::cycle(cycle_type stop_cycle) {
+  AllocationScope scope(_context.get());
+  HostProfiler::Run profile(_profiler.get());
+  HostProfiler* profiler = _profiler.get();
   uint32_t tile_count;
   bool is_accum_tile;
-  while (running()) {
+  while (running() && _core_cycles < stop_cycle) {
     int model_id = 0;
 
-    set_cycle_mask();
+    /* Stop issuing once a checkpoint is due and take it when everything drained */
+    bool draining = _config.checkpoint_interval > 0 && _core_cycles >= _next_checkpoint_cycle;
+    if (draining && can_checkpoint()) {
+      save_checkpoint();
+      draining = false;
+    }
+
+    set_cycle_mask(stop_cycle);
     // Core Cycle
     if (_cycle_mask & CORE_MASK) {
+      HostProfiler::Scope scheduler_scope(profiler, HostProfiler::SCHEDULER);
       /* Handle requested model */
-      handle_model();
+      if (!draining)
+        handle_model();
 
       for (int core_id = 0; core_id < _n_cores; core_id++) {
         std::unique_ptr<Tile> finished_tile = _cores[core_id]->pop_finished_tile();
         if (finished_tile->status == Tile::Status::FINISH) {
+          record_tile(*finished_tile);
           _scheduler->finish_tile(core_id, finished_tile->layer_id);
+          if (_trace) {
+            _trace->complete(TraceWriter::CORE_PID + core_id, TraceWriter::TILE_TRACK,
+                             finished_tile->optype, finished_tile->stat.start_cycle,
+                             finished_tile->stat.cycles,
+                             fmt::format("{{\"layer_id\":{}}}", finished_tile->layer_id));
+            trace_layer(finished_tile->layer_id);
+          }
         }
         // Issue new tile to core
-        if (!_scheduler->empty()) {
+        if (!_scheduler->empty() && !draining) {
           is_accum_tile = _scheduler->is_accum_tile(core_id, 0);
           if (_cores[core_id]->can_issue(is_accum_tile)) {
+            if (_config.work_stealing && !_cores[core_id]->running())
+              _scheduler->steal_tiles(core_id, _core_running_func);
             std::unique_ptr<Tile> tile = _scheduler->get_tile(core_id);
             if (tile->status == Tile::Status::INITIALIZED) {
+              if (_config.tile_memo_threshold > 0)
+                _cores[core_id]->set_memory_context(get_active_cores());
               _cores[core_id]->issue(std::move(tile));
+              for (auto& access : _cores[core_id]->pop_replayed_accesses())
+                _dram->record_replay(access.dram_address, access.write);
             }
           }
         }
-        _cores[core_id]->cycle();
+      }
+      {
+        HostProfiler::Scope core_scope(profiler, HostProfiler::CORE);
+        if (_thread_pool) {
+          _thread_pool->parallel_for(_n_cores, _core_cycle_func);
+        } else {
+          for (int core_id = 0; core_id < _n_cores; core_id++)
+            _cores[core_id]->cycle();
+        }
       }
       _core_cycles++;
+      if (_trace && _core_cycles >= _next_trace_cycle)
+        trace_dram();
+      /* Fast-forwarding may jump past a multiple of the interval */
+      if (profiler && _config.host_profile_interval > 0 && _core_cycles >= _next_profile_cycle) {
+        profiler->report_interval(_core_cycles);
+        _next_profile_cycle = (_core_cycles / _config.host_profile_interval + 1) *
+                              _config.host_profile_interval;
+      }
     }
 
     // DRAM cycle
     if (_cycle_mask & DRAM_MASK) {
+      HostProfiler::Scope dram_scope(profiler, HostProfiler::DRAM);
       _dram->cycle();
     }
     // Interconnect cycle
     if (_cycle_mask & ICNT_MASK) {
+      HostProfiler::Scope icnt_scope(profiler, HostProfiler::ICNT);
       for (int core_id = 0; core_id < _n_cores; core_id++) {
         // PUHS core to ICNT. memory request
         if (_cores[core_id]->has_memory_request()) {
@@ -173,13 +529,112 @@ void Simulator::cycle() {
       _icnt->cycle();
     }
   }
+}
+
+double Simulator::get_load_imbalance() {
+  cycle_type max_busy = 0;
+  double total_busy = 0;
+  for (auto& core : _cores) {
+    cycle_type busy = _core_cycles - core->get_idle_cycles();
+    max_busy = MAX(max_busy, busy);
+    total_busy += busy;
+  }
+  return total_busy > 0 ? max_busy / (total_busy / _n_cores) : 1.0;
+}
+
+/* Only printed once a model of the list carries an slo */
+void Simulator::print_tenant_stats() {
+  json tenants = get_tenant_stats();
+  bool has_slo = false;
+  for (auto& tenant : tenants)
+    has_slo = has_slo || tenant["slo_requests"] > 0;
+  if (!has_slo)
+    return;
+  for (auto& tenant : tenants) {
+    spdlog::info("Tenant {}: {} requests, SLO met {}/{} ({:.1f}%), latency p50 {:.1f} us "
+                 "p95 {:.1f} us p99 {:.1f} us max {:.1f} us",
+                 tenant["name"].get<std::string>(), tenant["requests"].get<uint64_t>(),
+                 tenant["slo_met"].get<uint64_t>(), tenant["slo_requests"].get<uint64_t>(),
+                 tenant["slo_attainment"].get<double>() * 100,
+                 tenant["latency_p50_ps"].get<uint64_t>() / 1e6,
+                 tenant["latency_p95_ps"].get<uint64_t>() / 1e6,
+                 tenant["latency_p99_ps"].get<uint64_t>() / 1e6,
+                 tenant["latency_max_ps"].get<uint64_t>() / 1e6);
+  }
+}
+
+void Simulator::print_stats() {
   spdlog::info("Simulation Finished");
+  if (_config.fast_forward)
+    spdlog::info("Fast-forwarded core cycles: {} / {}", _fast_forward_cycles, _core_cycles);
   /* Print simulation stats */
   for (int core_id = 0; core_id < _n_cores; core_id++) {
     _cores[core_id]->print_stats();
   }
+  cycle_type max_busy = 0;
+  uint64_t stolen_tiles = 0;
+  for (int core_id = 0; core_id < _n_cores; core_id++) {
+    max_busy = MAX(max_busy, _core_cycles - _cores[core_id]->get_idle_cycles());
+    stolen_tiles += _scheduler->get_stolen_tiles(core_id);
+  }
+  spdlog::info("Load imbalance: max busy cycles {} (max/mean {:.3f}), stolen tiles {}",
+               max_busy, get_load_imbalance(), stolen_tiles);
+  print_tenant_stats();
+  print_sampling_stats();
   _icnt->print_stats();
   _dram->print_stat();
+  if (!_config.stats_path.empty())
+    write_stats(_config.stats_path);
+  if (_trace) {
+    _trace->flush();
+    for (auto& core : _cores)
+      core->flush_trace();
+  }
+  if (_profiler)
+    _profiler->report(_core_cycles);
+}
+
+/*
+ * Per-layer results of sampled simulation merged across cores. The interval
+ * bounds the extrapolated cycles of each core at 95% confidence from the
+ * spread of its samples, summed over tile strata.
+ */
+void Simulator::print_sampling_stats() {
+  std::map<uint32_t, Core::LayerSample> layers;
+  std::map<uint32_t, double> bounds;
+  for (int core_id = 0; core_id < _n_cores; core_id++) {
+    for (auto& [layer_id, sample] : _cores[core_id]->get_layer_samples()) {
+      Core::LayerSample& layer = layers[layer_id];
+      layer.optype = sample.optype;
+      layer.detailed_tiles += sample.detailed_tiles;
+      layer.extrapolated_tiles += sample.extrapolated_tiles;
+      layer.dram_bytes += sample.dram_bytes;
+      layer.start_cycle = MIN(layer.start_cycle, sample.start_cycle);
+      layer.finish_cycle = MAX(layer.finish_cycle, sample.finish_cycle);
+      double bound = 0;
+      for (auto& [key, stratum] : sample.strata) {
+        if (stratum.samples < 2 || stratum.extrapolated_tiles == 0)
+          continue;
+        double mean = stratum.sum / stratum.samples;
+        double variance = MAX((stratum.sum_squares - stratum.samples * mean * mean) /
+                                  (stratum.samples - 1), 0.0);
+        bound += 1.96 * stratum.extrapolated_tiles * std::sqrt(variance / stratum.samples);
+      }
+      bounds[layer_id] = MAX(bounds[layer_id], bound);
+    }
+  }
+  for (auto& [layer_id, layer] : layers) {
+    cycle_type cycles = layer.finish_cycle > layer.start_cycle
+                            ? layer.finish_cycle - layer.start_cycle : 0;
+    double bandwidth = cycles ? (double)layer.dram_bytes / cycles : 0;
+    double bound = bounds[layer_id];
+    spdlog::info(
+        "Sampled layer {} {} : {} ± {:.0f} cycles, DRAM {:.2f} ± {:.2f} B/cycle, "
+        "{}/{} tiles detailed",
+        layer_id, layer.optype, cycles, bound, bandwidth,
+        cycles ? bandwidth * bound / cycles : 0, layer.detailed_tiles,
+        layer.detailed_tiles + layer.extrapolated_tiles);
+  }
 }
 
 void Simulator::register_model(std::unique_ptr<Model> model) {
@@ -199,8 +654,10 @@ bool Simulator::running() {
   return running;
 }
 
-void Simulator::set_cycle_mask() {
+void Simulator::set_cycle_mask(cycle_type stop_cycle) {
   _cycle_mask = 0x0;
+  if (_config.fast_forward && _core_time <= MIN(_dram_time, _icnt_time))
+    fast_forward(stop_cycle);
   uint64_t minimum_time = MIN3(_core_time, _dram_time, _icnt_time);
   if (_core_time <= minimum_time) {
     _cycle_mask |= CORE_MASK;
@@ -216,6 +673,196 @@ void Simulator::set_cycle_mask() {
   }
 }
 
+bool Simulator::can_fast_forward() {
+  if (!_icnt->is_idle() || !_dram->is_idle())
+    return false;
+  for (int core_id = 0; core_id < _n_cores; core_id++) {
+    if (_scheduler->empty())
+      break;
+    bool is_accum_tile = _scheduler->is_accum_tile(core_id, 0);
+    if (!_cores[core_id]->can_issue(is_accum_tile))
+      continue;
+    if (!_scheduler->can_fast_forward(core_id))
+      return false;
+    if (_config.work_stealing && !_cores[core_id]->running() &&
+        _scheduler->can_steal(core_id, _core_running_func))
+      return false;
+  }
+  return true;
+}
+
+/*
+ * Jump over core cycles in which no component can change state: cores only
+ * wait for pipeline entries with known finish cycles, the scheduler has no
+ * tile to hand out, and the interconnect and DRAM hold no access. The jump
+ * stops one cycle short of stop_cycle so step() never runs past its window.
+ */
+void Simulator::fast_forward(cycle_type stop_cycle) {
+  cycle_type target_cycle = UINT64_MAX;
+  for (int core_id = 0; core_id < _n_cores; core_id++) {
+    target_cycle = MIN(target_cycle, _cores[core_id]->get_next_event_cycle());
+    if (target_cycle <= _core_cycles + 1)
+      return;
+  }
+  /* Next model is launched at the first core cycle whose end passes its request time */
+  if (!_models.empty()) {
+    uint64_t request_time = _models.front()->get_request_time();
+    cycle_type request_cycle = request_time > _core_period
+                                   ? (request_time + _core_period - 1) / _core_period - 1
+                                   : 0;
+    target_cycle = MIN(target_cycle, request_cycle);
+  }
+  target_cycle = MIN(target_cycle, stop_cycle - 1);
+  if (target_cycle == UINT64_MAX || target_cycle <= _core_cycles + 1)
+    return;
+  if (!can_fast_forward())
+    return;
+
+  cycle_type core_cycles = target_cycle - _core_cycles;
+  uint64_t target_time = _core_time + core_cycles * _core_period;
+  cycle_type dram_cycles = 0;
+  cycle_type icnt_cycles = 0;
+  if (target_time > _dram_time)
+    dram_cycles = (target_time - _dram_time + _dram_period - 1) / _dram_period;
+  if (target_time > _icnt_time)
+    icnt_cycles = (target_time - _icnt_time + _icnt_period - 1) / _icnt_period;
+
+  for (int core_id = 0; core_id < _n_cores; core_id++)
+    _cores[core_id]->fast_forward(core_cycles);
+  _dram->fast_forward(dram_cycles);
+  _icnt->fast_forward(icnt_cycles);
+  _core_cycles += core_cycles;
+  _fast_forward_cycles += core_cycles;
+  _core_time = target_time;
+  _dram_time += dram_cycles * _dram_period;
+  _icnt_time += icnt_cycles * _icnt_period;
+}
+
+uint32_t Simulator::get_active_cores() {
+  uint32_t active_cores = 0;
+  for (auto &core : _cores)
+    active_cores += core->running();
+  return active_cores;
+}
+
+bool Simulator::can_checkpoint() {
+  if (!_icnt->is_idle() || !_dram->is_idle())
+    return false;
+  for (auto &core : _cores) {
+    if (!core->is_idle())
+      return false;
+  }
+  return true;
+}
+
+/*
+ * Checkpoints are taken with no tile, instruction or memory access in flight,
+ * so the state is the scheduler queues, layer progress of running models and
+ * per-component counters and statistics. Draining adds a short bubble to the
+ * checkpointing run, so it differs from a run without checkpoints; a restored
+ * run with the same interval reproduces the checkpointing run. Only counters
+ * of the DRAM and interconnect are saved, so Ramulator and Booksim2 resume
+ * precharged and empty.
+ */
+void Simulator::save_checkpoint() {
+  ModelCache::Writer writer;
+  writer.write(CHECKPOINT_MAGIC);
+  writer.write(CHECKPOINT_VERSION);
+  writer.write(_n_cores);
+  writer.write(_n_memories);
+  writer.write(_config.scheduler_type);
+  writer.write(_launched_models);
+  writer.write(_core_time);
+  writer.write(_dram_time);
+  writer.write(_icnt_time);
+  writer.write(_core_cycles);
+  writer.write(_fast_forward_cycles);
+  writer.write(get_allocation_state());
+  _scheduler->checkpoint(writer);
+  /* Tile sums carry over, individual tiles of stats_tiles do not */
+  writer.write<uint32_t>(_op_stats.size());
+  for (auto& [id, op] : _op_stats) {
+    writer.write(id);
+    for (uint64_t value : {op.tiles, op.compute_cycles, op.memory_stall, op.sram_reads,
+                           op.sram_writes})
+      writer.write(value);
+  }
+  for (auto &core : _cores)
+    core->checkpoint(writer);
+  _dram->checkpoint(writer);
+  _icnt->checkpoint(writer);
+
+  std::string path =
+      fs::path(_config.checkpoint_dir).append(fmt::format("checkpoint_{}.bin", _core_cycles));
+  if (ModelCache::save(path, writer.buffer()))
+    spdlog::info("Checkpoint at cycle {}: {}", _core_cycles, path);
+  else
+    spdlog::warn("Failed to write checkpoint {}", path);
+  _next_checkpoint_cycle = (_core_cycles / _config.checkpoint_interval + 1) * _config.checkpoint_interval;
+}
+
+bool Simulator::restore_checkpoint(std::string path) {
+  AllocationScope scope(_context.get());
+  if (_config.dram_type == DramType::RAMULATOR) {
+    spdlog::error("Checkpoint {} cannot be restored with Ramulator", path);
+    return false;
+  }
+  std::ifstream file(path, std::ios::binary);
+  std::string buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  if (!file.is_open() || buffer.size() < sizeof(CHECKPOINT_MAGIC) + sizeof(CHECKPOINT_VERSION))
+    return false;
+  ModelCache::Reader reader(buffer.data(), buffer.size());
+  if (reader.read<uint64_t>() != CHECKPOINT_MAGIC ||
+      reader.read<uint32_t>() != CHECKPOINT_VERSION ||
+      reader.read<uint32_t>() != _n_cores || reader.read<uint32_t>() != _n_memories ||
+      reader.read_string() != _config.scheduler_type) {
+    spdlog::error("Checkpoint {} does not match the configuration", path);
+    return false;
+  }
+  _launched_models = reader.read<uint32_t>();
+  if (_launched_models > _models.size()) {
+    spdlog::error("Checkpoint {} launched more models than registered", path);
+    return false;
+  }
+  _core_time = reader.read<uint64_t>();
+  _dram_time = reader.read<uint64_t>();
+  _icnt_time = reader.read<uint64_t>();
+  _core_cycles = reader.read<uint64_t>();
+  _fast_forward_cycles = reader.read<uint64_t>();
+  AllocationState allocation_state = reader.read<AllocationState>();
+
+  /* Models launch in request time order, so the first ones of the heap ran */
+  std::vector<std::unique_ptr<Model>> launched_models;
+  for (uint32_t i = 0; i < _launched_models; i++) {
+    launched_models.push_back(std::move(_models.front()));
+    std::pop_heap(_models.begin(), _models.end(), CompareModel());
+    _models.pop_back();
+    launched_models.back()->set_thread_pool(_thread_pool.get());
+  }
+  _scheduler->restore(reader, launched_models);
+  _op_stats.clear();
+  uint32_t num_ops = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < num_ops; i++) {
+    OpStat& op = _op_stats[reader.read<uint32_t>()];
+    for (uint64_t* value : {&op.tiles, &op.compute_cycles, &op.memory_stall, &op.sram_reads,
+                            &op.sram_writes})
+      *value = reader.read<uint64_t>();
+  }
+  for (auto &core : _cores)
+    core->restore(reader);
+  _dram->restore(reader);
+  _icnt->restore(reader);
+  set_allocation_state(allocation_state);
+  if (_config.checkpoint_interval > 0)
+    _next_checkpoint_cycle =
+        (_core_cycles / _config.checkpoint_interval + 1) * _config.checkpoint_interval;
+  if (_config.host_profile_interval > 0)
+    _next_profile_cycle =
+        (_core_cycles / _config.host_profile_interval + 1) * _config.host_profile_interval;
+  spdlog::info("Restore checkpoint {} at cycle {}", path, _core_cycles);
+  return true;
+}
+
 uint32_t Simulator::get_dest_node(MemoryAccess *access) {
   if (access->request) {
     return _config.num_cores + _dram->get_channel_id(access);
@@ -4,7 +4,10 @@
 #include "Core.h"
 #include "Dram.h"
 #include "Interconnect.h"
+#include "HostProfiler.h"
 #include "Model.h"
+#include "TraceWriter.h"
+#include "helper/ThreadPool.h"
 #include "scheduler/Scheduler.h"
 #include <queue>
 
@@ -12,29 +15,95 @@
 #define DRAM_MASK 0x1 << 2
 #define ICNT_MASK 0x1 << 3
 
+/*
+ * Each simulator allocates ids and addresses from its own context, so
+ * simulators may run concurrently on different threads. A simulator is used
+ * by one thread at a time and destroyed on the thread that created it.
+ */
 class Simulator {
  public:
+  struct LayerResult {
+    std::string name;
+    cycle_type start_cycle;
+    cycle_type finish_cycle;
+  };
+  struct CoreResult {
+    cycle_type compute_cycles;
+    cycle_type memory_stall_cycles;
+    cycle_type idle_cycles;
+    uint64_t stolen_tiles;
+  };
+  struct Stats {
+    cycle_type core_cycles;
+    uint64_t core_time; /* ps */
+    bool finished;
+    std::vector<CoreResult> cores;
+    std::vector<LayerResult> layers; /* Finished layers by finish cycle */
+    std::vector<ModelStat> models;   /* Finished models by finish time, with their ops */
+  };
+
   Simulator(SimulationConfig config);
+  static std::unique_ptr<Simulator> create(json config);
+  /* Models must be built with this simulator's context bound, as below */
   void register_model(std::unique_ptr<Model> model);
+  void register_model(json model_config, std::string onnx_path, std::string mapping_path,
+                      std::shared_ptr<const onnx::ModelProto> model_proto = nullptr);
   void run_simulator();
+  /* Simulate up to core_cycles more core cycles; false once all models finished */
+  bool step(cycle_type core_cycles);
+  void print_stats();
+  Stats get_stats();
+  /* Per-core, per-layer, per-model and per-DRAM-channel statistics as .json or .csv */
+  void write_stats(std::string path);
+  /* Resume from a checkpoint file; registered models must match the checkpointed run */
+  bool restore_checkpoint(std::string path);
+  cycle_type get_core_cycles() { return _core_cycles; }
+  uint64_t get_core_time() { return _core_time; } /* ps */
+  uint64_t get_core_period() { return _core_period; } /* ps */
+  /* Busy cycles of the busiest core over the mean across cores (1 is balanced) */
+  double get_load_imbalance();
   // void run_offline(std::string model_name, uint32_t sample_count);
   // void run_multistream(std::string model_name, uint32_t sample_count,
   // uint32_t ); void run_server(std::string trace_path);
  private:
-  void cycle();
+  void cycle(cycle_type stop_cycle);
   bool running();
-  void set_cycle_mask();
+  void set_cycle_mask(cycle_type stop_cycle);
+  bool can_fast_forward();
+  void fast_forward(cycle_type stop_cycle);
   void handle_model();
+  uint32_t get_active_cores();
+  bool can_checkpoint();
+  void save_checkpoint();
+  void print_sampling_stats();
+  void print_tenant_stats();
+  json get_tenant_stats();
+  void record_tile(Tile& tile);
+  void trace_layer(uint32_t layer_id);
+  void trace_dram();
+  std::vector<ModelStat> get_model_stats();
   uint32_t get_dest_node(MemoryAccess* access);
   SimulationConfig _config;
+  std::unique_ptr<AllocationContext> _context;
   uint32_t _n_cores;
   uint32_t _n_memories;
 
+  /* Declared before the components so their trace buffers flush first */
+  std::unique_ptr<TraceWriter> _trace_writer;
+  std::unique_ptr<TraceWriter::Buffer> _trace;
+  cycle_type _next_trace_cycle = 0;
+  cycle_type _next_profile_cycle = 0;
+  std::vector<uint64_t> _trace_dram_bytes;
+
   // Components
   std::vector<std::unique_ptr<Core>> _cores;
   std::unique_ptr<Interconnect> _icnt;
   std::unique_ptr<Dram> _dram;
   std::unique_ptr<Scheduler> _scheduler;
+  std::unique_ptr<ThreadPool> _thread_pool;
+  std::unique_ptr<HostProfiler> _profiler;
+  std::function<void(uint32_t)> _core_cycle_func;
+  std::function<bool(uint32_t)> _core_running_func;
   
   // period information (ps)
   uint64_t _core_period;
@@ -48,9 +117,12 @@ class Simulator {
   addr_type _dram_ch_stride_size;
 
   uint64_t _core_cycles;
+  uint64_t _fast_forward_cycles;
 
   uint32_t _cycle_mask;
   bool _single_run;
+  uint32_t _launched_models = 0;
+  cycle_type _next_checkpoint_cycle = 0;
 
   struct CompareModel {
     bool operator()(const std::unique_ptr<Model>& a, const std::unique_ptr<Model>& b) const {
@@ -58,4 +130,6 @@ class Simulator {
     }
   };
   std::vector<std::unique_ptr<Model>>  _models;
+  /* Finished tiles summed per layer */
+  std::map<uint32_t, OpStat> _op_stats;
 };
\ No newline at end of file
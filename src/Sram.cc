@@ -67,11 +67,11 @@ int Sram::prefetch(addr_type address, int buffer_id, size_t allocated_size,
   return 1;
 }
 
-void Sram::fill(addr_type address, int buffer_id) {
+void Sram::fill(addr_type address, int buffer_id, size_t count) {
   assert(check_allocated(address, buffer_id));
-  assert(_cache_table[buffer_id][address].remain_req_count > 0 &&
+  assert(_cache_table[buffer_id][address].remain_req_count >= count &&
          !_cache_table[buffer_id][address].valid);
-  _cache_table[buffer_id][address].remain_req_count--;
+  _cache_table[buffer_id][address].remain_req_count -= count;
   if (_cache_table[buffer_id][address].remain_req_count == 0) {
     _cache_table[buffer_id][address].valid = true;
     spdlog::trace("MAKE valid {} {}F", buffer_id, address);
@@ -93,4 +93,37 @@ void Sram::print_all(int buffer_id) {
   }
   spdlog::info("Allocated size: {:x}", _current_size[buffer_id]);
   spdlog::info("Size: {:x}", _size KB / _data_width / 2);
-}
\ No newline at end of file
+}
+
+void Sram::checkpoint(ModelCache::Writer& writer) {
+  for (int buffer_id = 0; buffer_id < 2; buffer_id++) {
+    writer.write(_current_size[buffer_id]);
+    writer.write<uint32_t>(_cache_table[buffer_id].size());
+    for (auto& [address, entry] : _cache_table[buffer_id]) {
+      writer.write(address);
+      writer.write(entry.valid);
+      writer.write(entry.address);
+      writer.write<uint64_t>(entry.size);
+      writer.write<uint64_t>(entry.remain_req_count);
+      writer.write(entry.timestamp);
+    }
+  }
+}
+
+void Sram::restore(ModelCache::Reader& reader) {
+  for (int buffer_id = 0; buffer_id < 2; buffer_id++) {
+    _current_size[buffer_id] = reader.read<int>();
+    _cache_table[buffer_id].clear();
+    uint32_t num_entries = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < num_entries; i++) {
+      addr_type address = reader.read<addr_type>();
+      SramEntry entry;
+      entry.valid = reader.read<bool>();
+      entry.address = reader.read<addr_type>();
+      entry.size = reader.read<uint64_t>();
+      entry.remain_req_count = reader.read<uint64_t>();
+      entry.timestamp = reader.read<cycle_type>();
+      _cache_table[buffer_id][address] = entry;
+    }
+  }
+}
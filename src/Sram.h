@@ -1,5 +1,6 @@
 #pragma once
 #include "Common.h"
+#include "ModelCache.h"
 
 class Sram {
  public:
@@ -14,10 +15,12 @@ class Sram {
   void flush(int buffer_id);
   int prefetch(addr_type address, int buffer_id, size_t allocated_size, size_t count);
   void count_up(addr_type, int buffer_id);
-  void fill(addr_type address, int buffer_id);
+  void fill(addr_type address, int buffer_id, size_t count = 1);
   int get_size() { return _size; }
   int get_current_size(int buffer_id) { return _current_size[buffer_id]; }
   void print_all(int buffer_id);
+  void checkpoint(ModelCache::Writer& writer);
+  void restore(ModelCache::Reader& reader);
  private:
   struct SramEntry {
     bool valid;
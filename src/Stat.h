@@ -2,24 +2,44 @@
 
 #include <stdint.h>
 
+#include <string>
 #include <vector>
 
 typedef struct {
   uint64_t start_cycle;
   uint64_t cycles;
-  uint64_t compute_cycles;
+  uint64_t compute_cycles; /* Cycles its instructions occupy the compute units */
   uint64_t memory_stall;
   uint64_t dependency_stall;
-  uint64_t sram_reads;
-  uint64_t sram_writes;
+  uint64_t sram_reads;     /* Bytes moved out of the scratchpads */
+  uint64_t sram_writes;    /* Bytes moved into the scratchpads */
+  uint32_t core_id;
 } TileStat;
 
 typedef struct {
+  uint32_t id;
+  std::string name;
+  std::string optype;
+  uint64_t start_cycle;
+  uint64_t finish_cycle;
   uint64_t op_cycles;
-  std::vector<TileStat> tile_stats;
+  /* Sums over the finished tiles of the op */
+  uint64_t tiles;
+  uint64_t compute_cycles;
+  uint64_t memory_stall;
+  uint64_t sram_reads;
+  uint64_t sram_writes;
+  std::vector<TileStat> tile_stats; /* Only kept with stats_tiles */
 } OpStat;
 
 typedef struct {
-  uint64_t total_cycles;
+  uint32_t request_id;
+  std::string name;
+  uint64_t request_time; /* ps */
+  uint64_t start_time;   /* ps */
+  uint64_t finish_time;  /* ps */
+  uint64_t finish_cycle;
+  uint64_t total_cycles; /* Core cycles from request to finish */
+  uint64_t slo;          /* ps, 0 without a latency target */
   std::vector<OpStat> op_stats;
 } ModelStat;
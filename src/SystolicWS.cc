@@ -61,12 +61,24 @@ void SystolicWS::cycle() {
     else
       _spad.fill(inst->dest_addr, inst->spad_id);
     _compute_pipeline.pop();
+    /* Pipelined instructions overlap, so a span ends where the next one starts */
+    if (_trace) {
+      cycle_type duration = MAX(inst->compute_size, 4);
+      if (!_compute_pipeline.empty())
+        duration = MIN(duration, _compute_pipeline.front()->start_cycle - inst->start_cycle);
+      _trace->complete(TraceWriter::CORE_PID + _id, TraceWriter::SYSTOLIC_TRACK,
+                       TraceWriter::opcode_name(inst->opcode), inst->start_cycle, duration);
+    }
   }
 
   /* Checking Vector compute pipeline */
   if (!_vector_pipeline.empty() &&
       _vector_pipeline.front()->finish_cycle <= _core_cycle) {
     std::unique_ptr<Instruction> inst = std::move(_vector_pipeline.front());
+    if (_trace)
+      _trace->complete(TraceWriter::CORE_PID + _id, TraceWriter::VECTOR_TRACK,
+                       TraceWriter::opcode_name(inst->opcode), inst->start_cycle,
+                       inst->finish_cycle - inst->start_cycle);
     if (inst->dest_addr >= ACCUM_SPAD_BASE)
       _acc_spad.fill(inst->dest_addr, inst->accum_spad_id);
     else
@@ -96,18 +108,20 @@ void SystolicWS::cycle() {
         spdlog::error("instruction panic opcode: {:x}, addr: {:x}, size: {:x}", (int)front->opcode, front->dest_addr, front->size);
         std::exit(EXIT_FAILURE);
       }
-      for (addr_type addr : front->src_addrs) {
+      for (auto it = front->src_addrs.begin(); it != front->src_addrs.end();) {
         assert(front->base_addr != GARBEGE_ADDR);
-        MemoryAccess *access =
-            new MemoryAccess({.id = generate_mem_access_id(),
-                              .dram_address = addr + front->base_addr,
-                              .spad_address = front->dest_addr,
-                              .size = _config.dram_req_size,
-                              .write = false,
-                              .request = true,
-                              .core_id = _id,
-                              .start_cycle = _core_cycle,
-                              .buffer_id = buffer_id});
+        addr_type dram_address = *it + front->base_addr;
+        uint32_t beats = get_burst_beats(it, front->src_addrs.end(), front->base_addr);
+        MemoryAccess *access = _access_pool.allocate();
+        *access = MemoryAccess{.id = generate_mem_access_id(),
+                               .dram_address = dram_address,
+                               .spad_address = front->dest_addr,
+                               .size = _config.dram_req_size * beats,
+                               .write = false,
+                               .request = true,
+                               .core_id = _id,
+                               .start_cycle = _core_cycle,
+                               .buffer_id = buffer_id};
         _request_queue.push(access);
       }
       _ld_inst_queue.pop();
@@ -200,18 +214,20 @@ void SystolicWS::cycle() {
         buffer_id = front->spad_id;
       }
       assert(buffer->check_hit(front->dest_addr, buffer_id));
-      for (addr_type addr : front->src_addrs) {
+      for (auto it = front->src_addrs.begin(); it != front->src_addrs.end();) {
         assert(front->base_addr != GARBEGE_ADDR);
-        MemoryAccess *access =
-            new MemoryAccess{.id = generate_mem_access_id(),
-                             .dram_address = addr + front->base_addr,
-                             .spad_address = front->dest_addr,
-                             .size = _config.dram_req_size,
-                             .write = true,
-                             .request = true,
-                             .core_id = _id,
-                             .start_cycle = _core_cycle,
-                             .buffer_id = buffer_id};
+        addr_type dram_address = *it + front->base_addr;
+        uint32_t beats = get_burst_beats(it, front->src_addrs.end(), front->base_addr);
+        MemoryAccess *access = _access_pool.allocate();
+        *access = MemoryAccess{.id = generate_mem_access_id(),
+                               .dram_address = dram_address,
+                               .spad_address = front->dest_addr,
+                               .size = _config.dram_req_size * beats,
+                               .write = true,
+                               .request = true,
+                               .core_id = _id,
+                               .start_cycle = _core_cycle,
+                               .buffer_id = buffer_id};
         _waiting_write_reqs++;
         _request_queue.push(access);
       }
@@ -220,13 +236,27 @@ void SystolicWS::cycle() {
       assert(0);
     }
   }
+  update_stats(1);
+  Core::cycle();
+}
+
+void SystolicWS::update_stats(cycle_type cycles) {
+  /* A replayed tile keeps the array busy for its compute share, then stalls */
+  if (_compute_pipeline.empty() && _vector_pipeline.empty()) {
+    cycle_type replay_compute = get_replay_compute_cycles(cycles);
+    _stat_compute_cycle += replay_compute;
+    _stat_matmul_cycle += replay_compute;
+    cycles -= replay_compute;
+    if (cycles == 0)
+      return;
+  }
   if (_compute_pipeline.empty() && _ex_inst_queue.empty()) {
-    _stat_memory_cycle++;
+    _stat_memory_cycle += cycles;
   } else if (!_compute_pipeline.empty()) {
-    _stat_compute_cycle++;
+    _stat_compute_cycle += cycles;
   }
   if (!_vector_pipeline.empty()) {  // Vector unit compute
-    _stat_vec_compute_cycle++;
+    _stat_vec_compute_cycle += cycles;
   }
 
   // xxx will it work well on double buffered code? no.
@@ -234,60 +264,105 @@ void SystolicWS::cycle() {
   is_idle = is_idle && _vector_pipeline.empty();
 
   if (is_idle) {
-    _stat_memory_cycle++;
+    _stat_memory_cycle += cycles;
 
     if (_ex_inst_queue.empty()) {
-      _store_memory_cycle++;
+      _store_memory_cycle += cycles;
     } else {
-      _load_memory_cycle++;
+      _load_memory_cycle += cycles;
       switch (_ex_inst_queue.front()->opcode) {
         case Opcode::GEMM:
         case Opcode::GEMM_PRELOAD:
-          _compute_memory_stall_cycle++;
+          _compute_memory_stall_cycle += cycles;
           break;
         case Opcode::LAYERNORM:
-          _layernorm_stall_cycle++;
+          _layernorm_stall_cycle += cycles;
           break;
         case Opcode::SOFTMAX:
-          _softmax_stall_cycle++;
+          _softmax_stall_cycle += cycles;
           break;
         case Opcode::ADD:
-          _add_stall_cycle++;
+          _add_stall_cycle += cycles;
           break;
         case Opcode::GELU:
-          _gelu_stall_cycle++;
+          _gelu_stall_cycle += cycles;
           break;
       }
     }
   } else if (!_compute_pipeline.empty()) {
-      _stat_matmul_cycle++;
+      _stat_matmul_cycle += cycles;
   } else {
     switch (_vector_pipeline.front()->opcode) {
       case Opcode::LAYERNORM:
-        _stat_layernorm_cycle++;
+        _stat_layernorm_cycle += cycles;
         break;
       case Opcode::SOFTMAX:
-        _stat_softmax_cycle++;
+        _stat_softmax_cycle += cycles;
         break;
       case Opcode::ADD:
-        _stat_add_cycle++;
+        _stat_add_cycle += cycles;
         break;
       case Opcode::GELU:
-        _stat_gelu_cycle++;
+        _stat_gelu_cycle += cycles;
         break;
     }
   }
 
   if (!running()) {
-    _stat_idle_cycle++;
+    _stat_idle_cycle += cycles;
   }
-  Core::cycle();
+}
+
+cycle_type SystolicWS::get_next_event_cycle() {
+  /* Any pending request, queued load/store or dispatchable instruction
+   * makes the very next cycle relevant */
+  if (!_finished_tiles.empty() || !_request_queue.empty() ||
+      !_ld_inst_queue.empty() || !_st_inst_queue.empty())
+    return _core_cycle;
+  if (!_ex_inst_queue.empty() && can_issue_compute(_ex_inst_queue.front()))
+    return _core_cycle;
+  if (can_dispatch_instruction())
+    return _core_cycle;
+
+  /* Otherwise nothing changes until a pipeline retires its front */
+  cycle_type next_cycle = UINT64_MAX;
+  if (!_compute_pipeline.empty())
+    next_cycle = MIN(next_cycle, _compute_pipeline.front()->finish_cycle);
+  if (!_vector_pipeline.empty())
+    next_cycle = MIN(next_cycle, _vector_pipeline.front()->finish_cycle);
+  /* A replayed tile retires in the Core::cycle() that reaches its finish cycle */
+  if (_replay_tile)
+    next_cycle = MIN(next_cycle, _replay_finish_cycle - 1);
+  return MAX(next_cycle, _core_cycle);
+}
+
+void SystolicWS::fast_forward(cycle_type cycles) {
+  update_stats(cycles);
+  Core::fast_forward(cycles);
 }
 
 cycle_type SystolicWS::get_inst_compute_cycles(std::unique_ptr<Instruction>& inst) {
   return _config.core_height + _config.core_width - 2 + MAX(inst->compute_size, 4);
 }
 
+/* Systolic instructions are pipelined, so only their issue interval is charged */
+cycle_type SystolicWS::get_inst_stat_cycles(std::unique_ptr<Instruction>& inst) {
+  switch (inst->opcode) {
+    case Opcode::GEMM:
+      return MAX(inst->compute_size, 4);
+    case Opcode::GEMM_PRELOAD:
+      return _config.core_height;
+    case Opcode::LAYERNORM:
+    case Opcode::SOFTMAX:
+    case Opcode::ADD:
+    case Opcode::GELU:
+    case Opcode::COMP:
+      return get_vector_compute_cycles(inst);
+    default:
+      return 0;
+  }
+}
+
 cycle_type SystolicWS::calculate_add_tree_iterations(uint32_t vector_size) {
   uint32_t calculation_unit = _config.vector_process_bit >> 3;
   if (vector_size <= calculation_unit) {
@@ -345,4 +420,23 @@ void SystolicWS::print_stats() {
                _stat_systolic_inst_issue_count);
   spdlog::info("Core [{}] : Systolic PRELOAD Issue Count : {}", _id,
                _stat_systolic_preload_issue_count);
-}
\ No newline at end of file
+}
+
+json SystolicWS::get_stats() {
+  json stats = Core::get_stats();
+  stats["systolic_inst_issue_count"] = _stat_systolic_inst_issue_count;
+  stats["systolic_preload_issue_count"] = _stat_systolic_preload_issue_count;
+  return stats;
+}
+
+void SystolicWS::checkpoint(ModelCache::Writer& writer) {
+  Core::checkpoint(writer);
+  writer.write(_stat_systolic_inst_issue_count);
+  writer.write(_stat_systolic_preload_issue_count);
+}
+
+void SystolicWS::restore(ModelCache::Reader& reader) {
+  Core::restore(reader);
+  _stat_systolic_inst_issue_count = reader.read<uint32_t>();
+  _stat_systolic_preload_issue_count = reader.read<uint32_t>();
+}
@@ -6,12 +6,19 @@ class SystolicWS : public Core {
   virtual bool can_issue(bool is_accum_tile);
   virtual void cycle() override;
   virtual void print_stats() override;
+  virtual json get_stats() override;
+  virtual cycle_type get_next_event_cycle() override;
+  virtual void fast_forward(cycle_type cycles) override;
+  virtual void checkpoint(ModelCache::Writer& writer) override;
+  virtual void restore(ModelCache::Reader& reader) override;
 
  protected:
   virtual cycle_type get_inst_compute_cycles(std::unique_ptr<Instruction>& inst) override;
+  virtual cycle_type get_inst_stat_cycles(std::unique_ptr<Instruction>& inst) override;
   uint32_t _stat_systolic_inst_issue_count = 0;
   uint32_t _stat_systolic_preload_issue_count = 0;
   cycle_type calculate_add_tree_iterations(uint32_t vector_size);
   cycle_type calculate_vector_op_iterations(uint32_t vector_size);
   cycle_type get_vector_compute_cycles(std::unique_ptr<Instruction>& inst);
+  void update_stats(cycle_type cycles);
 };
\ No newline at end of file
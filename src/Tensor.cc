@@ -31,6 +31,19 @@ Tensor::Tensor(uint32_t src_node, std::string name, std::vector<uint32_t> &dims,
   allocate_tensor(precision);
 }
 
+/* Restored from the model cache: the DRAM range is already reserved */
+Tensor::Tensor(uint32_t id, uint32_t src_node, std::string name,
+               std::vector<uint32_t> &dims, addr_type address, uint32_t size,
+               bool produced) {
+  _id = id;
+  _src_node = src_node;
+  _name = name;
+  _dims = dims;
+  _address = address;
+  _size = size;
+  _produced = produced;
+}
+
 Tensor::Tensor(const Tensor &tensor) {
   _produced = tensor._produced;
   _id = tensor._id;
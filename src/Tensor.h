@@ -9,6 +9,8 @@ class Tensor {
   Tensor(uint32_t src_node, onnx::TensorProto &tensor_proto, int precision, bool produced);
   Tensor(uint32_t src_node, std::string name, std::vector<uint32_t> &dims,
          int precision, bool produced);
+  Tensor(uint32_t id, uint32_t src_node, std::string name, std::vector<uint32_t> &dims,
+         addr_type address, uint32_t size, bool produced);
   Tensor(const Tensor &tensor);
 
   void redefine_tensor(uint32_t src_node, std::vector<uint32_t> &dims);
@@ -0,0 +1,110 @@
+#include "TraceWriter.h"
+
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+/* JSON string contents; ONNX node names may hold quotes, backslashes or control characters */
+std::string TraceWriter::escape(const std::string& value) {
+  std::string escaped;
+  for (char c : value) {
+    if (c == '"' || c == '\\')
+      escaped += {'\\', c};
+    else if ((unsigned char)c < 0x20)
+      escaped += fmt::format("\\u{:04x}", (unsigned char)c);
+    else
+      escaped += c;
+  }
+  return escaped;
+}
+
+void TraceWriter::Buffer::complete(uint32_t pid, uint32_t tid, const std::string& name,
+                                   cycle_type start, cycle_type duration,
+                                   const std::string& args) {
+  _events += fmt::format(",\n{{\"ph\":\"X\",\"pid\":{},\"tid\":{},\"name\":\"{}\",\"ts\":{},\"dur\":{}",
+                         pid, tid, escape(name), start, duration);
+  if (!args.empty())
+    _events += fmt::format(",\"args\":{}", args);
+  _events += "}";
+  if (_events.size() >= FLUSH_BYTES)
+    flush();
+}
+
+void TraceWriter::Buffer::counter(uint32_t pid, const std::string& name, cycle_type cycle,
+                                  const std::vector<std::pair<std::string, double>>& values) {
+  _events += fmt::format(",\n{{\"ph\":\"C\",\"pid\":{},\"name\":\"{}\",\"ts\":{},\"args\":{{",
+                         pid, escape(name), cycle);
+  for (size_t i = 0; i < values.size(); i++)
+    _events += fmt::format("{}\"{}\":{:.4f}", i ? "," : "", escape(values[i].first),
+                           values[i].second);
+  _events += "}}";
+  if (_events.size() >= FLUSH_BYTES)
+    flush();
+}
+
+void TraceWriter::Buffer::flush() {
+  if (_events.empty())
+    return;
+  _writer->append(_events);
+  _events.clear();
+}
+
+/* The array stays valid without its closing bracket if the run is cut short */
+TraceWriter::TraceWriter(std::string path, uint32_t num_cores) {
+  fs::path trace_path(path);
+  if (trace_path.has_parent_path())
+    fs::create_directories(trace_path.parent_path());
+  _file.open(path);
+  if (!_file.is_open()) {
+    spdlog::error("Failed to open trace file {}", path);
+    exit(EXIT_FAILURE);
+  }
+  _file << "[\n{\"ph\":\"M\",\"pid\":" << SCHEDULER_PID
+        << ",\"name\":\"process_name\",\"args\":{\"name\":\"Scheduler\"}}";
+  name_track(DRAM_PID, -1, "DRAM");
+  for (uint32_t core_id = 0; core_id < num_cores; core_id++) {
+    name_track(CORE_PID + core_id, -1, fmt::format("Core {}", core_id));
+    name_track(CORE_PID + core_id, TILE_TRACK, "Tiles");
+    name_track(CORE_PID + core_id, SYSTOLIC_TRACK, "Systolic array");
+    name_track(CORE_PID + core_id, VECTOR_TRACK, "Vector unit");
+  }
+  spdlog::info("Trace: {}", path);
+}
+
+TraceWriter::~TraceWriter() {
+  _file << "\n]\n";
+}
+
+void TraceWriter::append(const std::string& events) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _file << events;
+}
+
+/* tid -1 names the process */
+void TraceWriter::name_track(uint32_t pid, int tid, std::string name) {
+  if (tid < 0)
+    _file << fmt::format(",\n{{\"ph\":\"M\",\"pid\":{},\"name\":\"process_name\","
+                         "\"args\":{{\"name\":\"{}\"}}}}", pid, escape(name));
+  else
+    _file << fmt::format(",\n{{\"ph\":\"M\",\"pid\":{},\"tid\":{},\"name\":\"thread_name\","
+                         "\"args\":{{\"name\":\"{}\"}}}}", pid, tid, escape(name));
+}
+
+const char* TraceWriter::opcode_name(Opcode opcode) {
+  switch (opcode) {
+    case Opcode::MOVIN: return "MOVIN";
+    case Opcode::MOVOUT: return "MOVOUT";
+    case Opcode::MOVOUT_POOL: return "MOVOUT_POOL";
+    case Opcode::GEMM_PRELOAD: return "GEMM_PRELOAD";
+    case Opcode::GEMM: return "GEMM";
+    case Opcode::GEMM_WRITE: return "GEMM_WRITE";
+    case Opcode::COMP: return "COMP";
+    case Opcode::IM2COL: return "IM2COL";
+    case Opcode::SOFTMAX: return "SOFTMAX";
+    case Opcode::LAYERNORM: return "LAYERNORM";
+    case Opcode::ADD: return "ADD";
+    case Opcode::GELU: return "GELU";
+    case Opcode::BAR: return "BAR";
+  }
+  return "UNKNOWN";
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <fstream>
+#include <mutex>
+#include <string>
+
+#include "Common.h"
+
+/*
+ * Timeline in the Chrome trace event format (JSON array), viewable in
+ * Perfetto UI or chrome://tracing. Timestamps are core cycles written as
+ * microseconds. Each producer fills its own Buffer, which is appended to the
+ * file once it passes FLUSH_BYTES, so memory stays bounded on long runs and
+ * cores stepped on different threads do not contend per event.
+ */
+class TraceWriter {
+ public:
+  static constexpr size_t FLUSH_BYTES = 1 << 20;
+  /* Processes of the timeline; core i is CORE_PID + i */
+  static constexpr uint32_t SCHEDULER_PID = 0;
+  static constexpr uint32_t DRAM_PID = 1;
+  static constexpr uint32_t CORE_PID = 2;
+  /* Threads of a core process */
+  enum CoreTrack : uint32_t { TILE_TRACK, SYSTOLIC_TRACK, VECTOR_TRACK };
+
+  class Buffer {
+   public:
+    Buffer(TraceWriter* writer) : _writer(writer) {}
+    ~Buffer() { flush(); }
+    /* A span of duration cycles; args is a JSON object or empty, strings in it escaped */
+    void complete(uint32_t pid, uint32_t tid, const std::string& name, cycle_type start,
+                  cycle_type duration, const std::string& args = "");
+    /* A sample of each named series of a counter track */
+    void counter(uint32_t pid, const std::string& name, cycle_type cycle,
+                 const std::vector<std::pair<std::string, double>>& values);
+    void flush();
+
+   private:
+    TraceWriter* _writer;
+    std::string _events;
+  };
+
+  TraceWriter(std::string path, uint32_t num_cores);
+  ~TraceWriter();
+  static const char* opcode_name(Opcode opcode);
+  /* value escaped for use inside a JSON string */
+  static std::string escape(const std::string& value);
+
+ private:
+  void append(const std::string& events);
+  void name_track(uint32_t pid, int tid, std::string name);
+  std::ofstream _file;
+  std::mutex _mutex;
+};
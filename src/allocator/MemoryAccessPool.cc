@@ -0,0 +1,29 @@
+#include "MemoryAccessPool.h"
+
+MemoryAccessPool::MemoryAccessPool(uint32_t chunk_size)
+    : _chunk_size(chunk_size) {}
+
+MemoryAccess* MemoryAccessPool::allocate() {
+  if (_free_list.empty())
+    grow();
+  MemoryAccess* access = _free_list.back();
+  _free_list.pop_back();
+  _in_use++;
+  _high_water_mark = MAX(_high_water_mark, _in_use);
+  return access;
+}
+
+void MemoryAccessPool::free(MemoryAccess* access) {
+  assert(_in_use > 0);
+  _free_list.push_back(access);
+  _in_use--;
+}
+
+void MemoryAccessPool::grow() {
+  _chunks.push_back(std::make_unique<MemoryAccess[]>(_chunk_size));
+  MemoryAccess* chunk = _chunks.back().get();
+  _free_list.reserve(get_capacity());
+  /* Hand out lower addresses first */
+  for (uint32_t i = _chunk_size; i > 0; i--)
+    _free_list.push_back(&chunk[i - 1]);
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "../Common.h"
+
+/*
+ * Free-list arena for MemoryAccess objects. Each core owns one pool: requests
+ * are allocated when the core issues them and return to the same core as
+ * responses, so the pool needs no locking even when cores run in parallel.
+ */
+class MemoryAccessPool {
+ public:
+  MemoryAccessPool(uint32_t chunk_size = 4096);
+  MemoryAccess* allocate();
+  void free(MemoryAccess* access);
+  uint64_t get_in_use() { return _in_use; }
+  uint64_t get_high_water_mark() { return _high_water_mark; }
+  uint64_t get_capacity() { return _chunks.size() * _chunk_size; }
+
+ private:
+  void grow();
+
+  uint32_t _chunk_size;
+  std::vector<std::unique_ptr<MemoryAccess[]>> _chunks;
+  std::vector<MemoryAccess*> _free_list;
+  uint64_t _in_use = 0;
+  uint64_t _high_water_mark = 0;
+};
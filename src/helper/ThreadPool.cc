@@ -0,0 +1,86 @@
+#include "ThreadPool.h"
+
+#include <chrono>
+
+#define SPIN_LIMIT 1024
+#define PARK_MICROSECONDS 1000
+
+ThreadPool::ThreadPool(uint32_t num_threads, std::function<void()> worker_init) {
+  for (uint32_t i = 1; i < num_threads; i++)
+    _workers.emplace_back(&ThreadPool::worker_loop, this, worker_init);
+}
+
+ThreadPool::~ThreadPool() {
+  _stop.store(true, std::memory_order_release);
+  _generation.fetch_add(1);
+  wake_workers();
+  for (auto& worker : _workers)
+    worker.join();
+}
+
+void ThreadPool::parallel_for(uint32_t count,
+                              const std::function<void(uint32_t)>& func) {
+  if (_workers.empty() || count <= 1) {
+    for (uint32_t i = 0; i < count; i++)
+      func(i);
+    return;
+  }
+  _func = &func;
+  _count = count;
+  _next_index.store(0, std::memory_order_relaxed);
+  _busy_workers.store(_workers.size(), std::memory_order_relaxed);
+  _generation.fetch_add(1);
+  wake_workers();
+
+  run_tasks();
+  int spin = 0;
+  while (_busy_workers.load(std::memory_order_acquire) != 0) {
+    if (++spin > SPIN_LIMIT)
+      std::this_thread::yield();
+  }
+}
+
+void ThreadPool::run_tasks() {
+  uint32_t index;
+  while ((index = _next_index.fetch_add(1, std::memory_order_relaxed)) < _count)
+    (*_func)(index);
+}
+
+/*
+ * _generation and _parked_workers are sequentially consistent: either a parking
+ * worker sees the new generation or the publisher sees the parked worker.
+ */
+void ThreadPool::wake_workers() {
+  if (_parked_workers.load() == 0)
+    return;
+  { std::lock_guard<std::mutex> lock(_park_mutex); }
+  _park_cv.notify_all();
+}
+
+void ThreadPool::worker_loop(std::function<void()> worker_init) {
+  if (worker_init)
+    worker_init();
+  uint64_t generation = 0;
+  while (true) {
+    int spin = 0;
+    auto idle_start = std::chrono::steady_clock::now();
+    while (_generation.load(std::memory_order_acquire) == generation) {
+      if (++spin <= SPIN_LIMIT)
+        continue;
+      std::this_thread::yield();
+      if (spin % SPIN_LIMIT != 0 ||
+          std::chrono::steady_clock::now() - idle_start <
+              std::chrono::microseconds(PARK_MICROSECONDS))
+        continue;
+      std::unique_lock<std::mutex> lock(_park_mutex);
+      _parked_workers.fetch_add(1);
+      _park_cv.wait(lock, [&]() { return _generation.load() != generation; });
+      _parked_workers.fetch_sub(1);
+    }
+    generation = _generation.load(std::memory_order_acquire);
+    if (_stop.load(std::memory_order_acquire))
+      return;
+    run_tasks();
+    _busy_workers.fetch_sub(1, std::memory_order_release);
+  }
+}
@@ -0,0 +1,47 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Fixed-size pool of workers for fine-grained fork/join work.
+ * parallel_for() hands out indices dynamically and returns only after every
+ * index has been processed, so each call acts as a barrier. The calling
+ * thread takes part in the work. Workers run worker_init once when started.
+ * Idle workers spin, then yield, and park on a condition variable once no
+ * work arrived for PARK_MICROSECONDS, so an idle pool holds no host cores.
+ */
+class ThreadPool {
+ public:
+  ThreadPool(uint32_t num_threads, std::function<void()> worker_init = nullptr);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  void parallel_for(uint32_t count, const std::function<void(uint32_t)>& func);
+  uint32_t size() { return _workers.size() + 1; }
+
+ private:
+  void worker_loop(std::function<void()> worker_init);
+  void run_tasks();
+  void wake_workers();
+
+  std::vector<std::thread> _workers;
+  const std::function<void(uint32_t)>* _func = nullptr;
+  uint32_t _count = 0;
+  std::atomic<uint32_t> _next_index{0};
+  std::atomic<uint32_t> _busy_workers{0};
+  std::atomic<uint64_t> _generation{0};
+  std::atomic<bool> _stop{false};
+  std::mutex _park_mutex;
+  std::condition_variable _park_cv;
+  std::atomic<uint32_t> _parked_workers{0};
+};
+
+#endif
@@ -1,14 +1,117 @@
 #include <fstream>
 #include <chrono>
 #include <filesystem>
+#include <mutex>
+#include <thread>
 
+#include "Serving.h"
 #include "Simulator.h"
 #include "helper/CommandLineParser.h"
-#include "operations/OperationFactory.h"
 
 namespace fs = std::filesystem;
 namespace po = boost::program_options;
 
+std::unique_ptr<Simulator> create_simulator(json config, json& models_list,
+                                            std::string model_base_path,
+                                            ModelProtos* model_protos = nullptr) {
+  auto simulator = Simulator::create(config);
+  for (json model_config : models_list["models"]) {
+    std::string model_name = model_config["name"];
+    std::string onnx_path =
+        fmt::format("{}/{}/{}.onnx", model_base_path, model_name, model_name);
+    std::string mapping_path = fmt::format("{}/{}/{}.mapping", model_base_path,
+                                           model_name, model_name);
+    simulator->register_model(model_config, onnx_path, mapping_path,
+                              model_protos != nullptr ? model_protos->at(model_name) : nullptr);
+  }
+  return simulator;
+}
+
+/* Every combination of the grid values ({"key": [values]}) over the base config */
+std::vector<json> expand_grid(json base_config, json grid) {
+  std::vector<json> points = {base_config};
+  for (auto& [key, values] : grid.items()) {
+    std::vector<json> expanded;
+    for (auto& point : points) {
+      for (auto& value : values) {
+        json next = point;
+        next[key] = value;
+        expanded.push_back(next);
+      }
+    }
+    points = expanded;
+  }
+  return points;
+}
+
+/* <stem>_point<index><extension>, so sweep points never share an output file */
+std::string point_path(fs::path path, uint32_t index) {
+  std::string extension = path.extension().string();
+  return path.replace_extension().string() + fmt::format("_point{}", index) + extension;
+}
+
+/*
+ * Simulate every grid point on its own thread, sharing the parsed ONNX
+ * graphs. Each simulator allocates from its own id and address counters, so
+ * points produce the same results as separate runs. Rows are written as
+ * points finish.
+ */
+void run_sweep(json base_config, std::string grid_path, json& models_list,
+               std::string model_base_path, uint32_t num_threads, std::string output_path) {
+  json grid;
+  std::ifstream grid_file(grid_path);
+  grid_file >> grid;
+  grid_file.close();
+  std::vector<json> points = expand_grid(base_config, grid);
+
+  ModelProtos model_protos;
+  for (json model_config : models_list["models"]) {
+    std::string model_name = model_config["name"];
+    if (model_protos.find(model_name) == model_protos.end())
+      model_protos[model_name] = Model::load_onnx(
+          fmt::format("{}/{}/{}.onnx", model_base_path, model_name, model_name));
+  }
+
+  std::ofstream output(output_path);
+  output << "point";
+  for (auto& [key, values] : grid.items())
+    output << "," << key;
+  output << ",cycles,simulation_seconds" << std::endl;
+  std::mutex output_mutex;
+
+  spdlog::info("Sweep of {} points on {} threads", points.size(), num_threads);
+  ThreadPool thread_pool(MAX(MIN(num_threads, points.size()), 1));
+  thread_pool.parallel_for(points.size(), [&](uint32_t index) {
+    auto start = std::chrono::high_resolution_clock::now();
+    /* Points write their statistics, traces and checkpoints side by side */
+    json& point = points[index];
+    for (std::string key : {"stats_path", "trace_path"}) {
+      if (point.contains(key) && point[key] != "")
+        point[key] = point_path(point[key].get<std::string>(), index);
+    }
+    if (point.contains("checkpoint_interval") && point["checkpoint_interval"] != 0) {
+      std::string checkpoint_dir = point.contains("checkpoint_dir")
+                                       ? point["checkpoint_dir"].get<std::string>()
+                                       : SimulationConfig().checkpoint_dir;
+      point["checkpoint_dir"] = point_path(checkpoint_dir, index);
+    }
+    auto simulator = create_simulator(points[index], models_list, model_base_path, &model_protos);
+    simulator->run_simulator();
+    cycle_type cycles = simulator->get_core_cycles();
+    simulator.reset();
+    std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start;
+
+    std::string row = std::to_string(index);
+    for (auto& [key, values] : grid.items()) {
+      json& value = points[index][key];
+      row += "," + (value.is_string() ? value.get<std::string>() : value.dump());
+    }
+    std::lock_guard<std::mutex> lock(output_mutex);
+    output << row << "," << cycles << "," << duration.count() << std::endl;
+    spdlog::info("Sweep point {} finished: {} cycles", index, cycles);
+  });
+}
+
 int main(int argc, char** argv) {
   auto start = std::chrono::high_resolution_clock::now();
   // parse command line argumnet
@@ -21,6 +124,24 @@ int main(int argc, char** argv) {
       "log_level", "Set for log level [trace, debug, info], default = info");
   cmd_parser.add_command_line_option<std::string>(
       "mode", "choose one_model or two_model");
+  cmd_parser.add_command_line_option<std::string>(
+      "restore", "Path for a checkpoint file to resume from");
+  cmd_parser.add_command_line_option<std::string>(
+      "sweep", "Path for a parameter grid to simulate over the config");
+  cmd_parser.add_command_line_option<std::string>(
+      "sweep_output", "Path for the sweep results, default = sweep.csv");
+  cmd_parser.add_command_line_option<uint32_t>(
+      "sweep_threads", "Simulations run in parallel, default = hardware threads");
+  cmd_parser.add_command_line_option<std::string>(
+      "serving_trace", "Path for a JSONL arrival trace to serve");
+  cmd_parser.add_command_line_option<double>(
+      "serving_qps", "Serve Poisson arrivals of the models list at this rate (requests/s)");
+  cmd_parser.add_command_line_option<uint32_t>(
+      "serving_requests", "Poisson arrivals to serve, default = 100");
+  cmd_parser.add_command_line_option<uint64_t>(
+      "serving_seed", "Seed of the Poisson arrivals, default = 1");
+  cmd_parser.add_command_line_option<uint32_t>(
+      "serving_max_batch", "Continuously batch generation requests, at most this many in flight");
 
   try {
     cmd_parser.parse(argc, argv);
@@ -51,8 +172,6 @@ int main(int argc, char** argv) {
   std::ifstream config_file(config_path);
   config_file >> config_json;
   config_file.close();
-  SimulationConfig config = initialize_config(config_json);
-  OperationFactory::initialize(config);
 
   std::string models_list_path;
   cmd_parser.set_if_defined("models_list", &models_list_path);
@@ -60,18 +179,53 @@ int main(int argc, char** argv) {
   json models_list;
   models_list_file >> models_list;
   models_list_file.close();
-  auto simulator = std::make_unique<Simulator>(config);
-  for (json model_config : models_list["models"]) {
-    std::string model_name = model_config["name"];
-    std::string onnx_path =
-        fmt::format("{}/{}/{}.onnx", model_base_path, model_name, model_name);
-    std::string mapping_path = fmt::format("{}/{}/{}.mapping", model_base_path,
-                                           model_name, model_name);
-    MappingTable mapping_table = MappingTable::parse_mapping_file(mapping_path, config);
 
-    auto model = std::make_unique<Model>(onnx_path, model_config, config, model_name, mapping_table);
-    spdlog::info("Register model: {}", model_name);
-    simulator->register_model(std::move(model));
+  std::string grid_path;
+  cmd_parser.set_if_defined("sweep", &grid_path);
+  if (!grid_path.empty()) {
+    std::string output_path = "sweep.csv";
+    uint32_t num_threads = std::thread::hardware_concurrency();
+    cmd_parser.set_if_defined("sweep_output", &output_path);
+    cmd_parser.set_if_defined("sweep_threads", &num_threads);
+    run_sweep(config_json, grid_path, models_list, model_base_path, num_threads, output_path);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration = end - start;
+    spdlog::info("Simulation time: {:2f} seconds", duration.count());
+    return 0;
+  }
+
+  std::string trace_path;
+  double qps = 0;
+  cmd_parser.set_if_defined("serving_trace", &trace_path);
+  cmd_parser.set_if_defined("serving_qps", &qps);
+  if (!trace_path.empty() || qps > 0) {
+    uint32_t num_requests = 100;
+    uint64_t seed = 1;
+    cmd_parser.set_if_defined("serving_requests", &num_requests);
+    cmd_parser.set_if_defined("serving_seed", &seed);
+    std::vector<json> requests =
+        !trace_path.empty() ? Serving::read_trace(trace_path, models_list)
+                            : Serving::poisson_trace(models_list, qps, num_requests, seed);
+    uint32_t max_batch = 0;
+    cmd_parser.set_if_defined("serving_max_batch", &max_batch);
+    auto simulator = Simulator::create(config_json);
+    std::unique_ptr<Serving> serving =
+        max_batch > 0 ? std::make_unique<ContinuousBatching>(simulator.get(), requests,
+                                                             model_base_path, max_batch)
+                      : std::make_unique<Serving>(simulator.get(), requests, model_base_path);
+    serving->run();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration = end - start;
+    spdlog::info("Simulation time: {:2f} seconds", duration.count());
+    return 0;
+  }
+
+  auto simulator = create_simulator(config_json, models_list, model_base_path);
+  std::string checkpoint_path;
+  cmd_parser.set_if_defined("restore", &checkpoint_path);
+  if (!checkpoint_path.empty() && !simulator->restore_checkpoint(checkpoint_path)) {
+    spdlog::error("Failed to restore checkpoint {}", checkpoint_path);
+    exit(EXIT_FAILURE);
   }
   simulator->run_simulator();
 
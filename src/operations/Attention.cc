@@ -56,6 +56,13 @@ Attention::Attention(SimulationConfig config, Model* model,
     } else {
         pre_defind_tensor->redefine_tensor(_id, _output_shape);
     }
+
+    /* Intermediate tensor written by the linear projection */
+    std::unique_ptr<Tensor> linear_output = std::make_unique<Tensor>(
+        _id, "", _liner_output_shape, _config.precision, true);
+    _linear_output_id = _INPUT_OPERAND + _inputs.size();
+    _inputs.push_back(linear_output.get()->get_id());
+    _model->add_tensor(std::move(linear_output));
     calculate_loops();
 }
 
@@ -69,17 +76,12 @@ void Attention::initialize_tiles(MappingTable& mapping_table) {
     /* linear projection */
     uint32_t fused_op_id = 0;
     GemmWS linear_projection = GemmWS(_config, mapping_table, _input_shape, _weight_shape, _liner_output_shape);
-    std::unique_ptr<Tensor> linear_output = std::make_unique<Tensor>(
-        _id, "", _liner_output_shape, _config.precision, true);
 
     /* Set tensor */
     linear_projection.set_model(_model);
     linear_projection.add_input(_inputs.at(0));
     linear_projection.add_input(_inputs.at(1));
-    linear_projection.add_output(linear_output.get()->get_id());
-    _linear_output_id = _INPUT_OPERAND + _inputs.size();
-    _inputs.push_back(linear_output.get()->get_id());
-    _model->add_tensor(std::move(linear_output));
+    linear_projection.add_output(_inputs.at(_linear_output_id - _INPUT_OPERAND));
 
     /* Initilize tiles */
     linear_projection.has_bias = false;
@@ -167,21 +169,21 @@ void Attention::initialize_instructions(Tile* tile, Mapping mapping, int head_id
             .opcode = Opcode::MOVIN,
             .dest_addr = sram_q_ofs,
             .size = (uint32_t)dram_query_addrs.size(),
-            .src_addrs = std::vector<addr_type>(dram_query_addrs.begin(), dram_query_addrs.end()),
+            .src_addrs = AddressList(dram_query_addrs.begin(), dram_query_addrs.end()),
             .operand_id = _INPUT_OPERAND,  // query
         }));
         tile->instructions.push_back(std::make_unique<Instruction>(Instruction{
             .opcode = Opcode::MOVIN,
             .dest_addr = sram_k_ofs,
             .size = (uint32_t)dram_key_addrs.size(),
-            .src_addrs = std::vector<addr_type>(dram_key_addrs.begin(), dram_key_addrs.end()),
+            .src_addrs = AddressList(dram_key_addrs.begin(), dram_key_addrs.end()),
             .operand_id = _INPUT_OPERAND + 1,  // key
         }));
         tile->instructions.push_back(std::make_unique<Instruction>(Instruction{
             .opcode = Opcode::MOVIN,
             .dest_addr = sram_v_ofs,
             .size = (uint32_t)dram_value_addrs.size(),
-            .src_addrs = std::vector<addr_type>(dram_value_addrs.begin(), dram_value_addrs.end()),
+            .src_addrs = AddressList(dram_value_addrs.begin(), dram_value_addrs.end()),
             .operand_id = _INPUT_OPERAND + 2,  // value
         }));
         // -- compute --
@@ -229,7 +231,7 @@ void Attention::initialize_instructions(Tile* tile, Mapping mapping, int head_id
             .opcode = Opcode::MOVOUT,
             .dest_addr = sram_l_ofs,
             .size = (uint32_t)dram_output_addrs.size(),
-            .src_addrs = std::vector<addr_type>(dram_output_addrs.begin(), dram_output_addrs.end()),
+            .src_addrs = AddressList(dram_output_addrs.begin(), dram_output_addrs.end()),
             .operand_id = _OUTPUT_OPERAND,
         }));
     }
@@ -239,17 +241,12 @@ void Attention::initialize_non_fused_tiles(MappingTable& mapping_table) {
     /* linear projection */
     uint32_t fused_op_id = 0;
     GemmWS linear_projection = GemmWS(_config, mapping_table, _input_shape, _weight_shape, _liner_output_shape);
-    std::unique_ptr<Tensor> linear_output = std::make_unique<Tensor>(
-        _id, "", _liner_output_shape, _config.precision, true);
 
     /* Set tensor */
     linear_projection.set_model(_model);
     linear_projection.add_input(_inputs.at(0));
     linear_projection.add_input(_inputs.at(1));
-    linear_projection.add_output(linear_output.get()->get_id());
-    _linear_output_id = _INPUT_OPERAND + _inputs.size();
-    _inputs.push_back(linear_output.get()->get_id());
-    _model->add_tensor(std::move(linear_output));
+    linear_projection.add_output(_inputs.at(_linear_output_id - _INPUT_OPERAND));
 
     /* Initilize tiles */
     linear_projection.has_bias = false;
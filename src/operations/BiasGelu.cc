@@ -69,7 +69,7 @@ void BiasGelu::initialize_instructions(Tile* tile, Mapping mapping, uint32_t tok
         .opcode = Opcode::MOVIN,
         .dest_addr = sram_base,
         .size = (uint32_t)dram_addrs.size(),
-        .src_addrs = std::vector<addr_type>(dram_addrs.begin(), dram_addrs.end()),
+        .src_addrs = AddressList(dram_addrs.begin(), dram_addrs.end()),
         .operand_id = _INPUT_OPERAND,  // query
     }));
 
@@ -77,7 +77,7 @@ void BiasGelu::initialize_instructions(Tile* tile, Mapping mapping, uint32_t tok
         .opcode = Opcode::MOVIN,
         .dest_addr = sram_bias_base,
         .size = (uint32_t)dram_skip_addrs.size(),
-        .src_addrs = std::vector<addr_type>(dram_skip_addrs.begin(), dram_skip_addrs.end()),
+        .src_addrs = AddressList(dram_skip_addrs.begin(), dram_skip_addrs.end()),
         .operand_id = _INPUT_OPERAND+1,  // query
     }));
 
@@ -101,7 +101,7 @@ void BiasGelu::initialize_instructions(Tile* tile, Mapping mapping, uint32_t tok
         .opcode = Opcode::MOVOUT,
         .dest_addr = sram_base,
         .size = (uint32_t)dram_output_addrs.size(),
-        .src_addrs = std::vector<addr_type>(dram_output_addrs.begin(), dram_output_addrs.end()),
+        .src_addrs = AddressList(dram_output_addrs.begin(), dram_output_addrs.end()),
         .operand_id = _OUTPUT_OPERAND,
     }));
 }
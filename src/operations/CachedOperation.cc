@@ -0,0 +1,20 @@
+#include "CachedOperation.h"
+
+CachedOperation::CachedOperation(SimulationConfig config, Model* model,
+                                 uint32_t id, std::string name,
+                                 std::string optype,
+                                 std::shared_ptr<ModelCache> cache,
+                                 const char* tile_data,
+                                 ModelCache::Relocation relocation)
+    : Operation(config, model, id),
+      _cache(cache),
+      _tile_data(tile_data),
+      _relocation(relocation) {
+  _name = name;
+  _optype = optype;
+}
+
+void CachedOperation::initialize_tiles(MappingTable& mapping_table) {
+  ModelCache::Reader reader(_tile_data, _cache->data() + _cache->size() - _tile_data);
+  reader.read_tiles(_tiles, _relocation);
+}
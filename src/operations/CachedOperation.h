@@ -0,0 +1,18 @@
+#pragma once
+#include "Operation.h"
+#include "../ModelCache.h"
+
+/* Layer restored from the model cache; tiles are decoded when pulled */
+class CachedOperation : public Operation {
+ public:
+  CachedOperation(SimulationConfig config, Model* model, uint32_t id,
+                  std::string name, std::string optype,
+                  std::shared_ptr<ModelCache> cache, const char* tile_data,
+                  ModelCache::Relocation relocation);
+  void initialize_tiles(MappingTable& mapping_table) override;
+
+ private:
+  std::shared_ptr<ModelCache> _cache;
+  const char* _tile_data;
+  ModelCache::Relocation _relocation;
+};
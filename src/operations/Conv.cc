@@ -188,7 +188,7 @@ void Conv::im2col_nhwc() {
           .opcode = Opcode::MOVIN,
           .dest_addr = SPAD_BASE,
           .size = (uint32_t)dest_set.size(),
-          .src_addrs = std::vector<addr_type>(src_set.begin(), src_set.end()),
+          .src_addrs = AddressList(src_set.begin(), src_set.end()),
           .operand_id = _INPUT_OPERAND}));
       tile->instructions.push_back(std::make_unique<Instruction>(Instruction{
                       .opcode = Opcode::IM2COL,
@@ -198,7 +198,7 @@ void Conv::im2col_nhwc() {
           .opcode = Opcode::MOVOUT,
           .dest_addr = SPAD_BASE,
           .size = (uint32_t)dest_set.size(),
-          .src_addrs = std::vector<addr_type>(dest_set.begin(), dest_set.end()),
+          .src_addrs = AddressList(dest_set.begin(), dest_set.end()),
           .operand_id = _INPUT_OPERAND + 4}));
 
       data_col_tmp += kernel_h * kernel_w * channels;
@@ -251,7 +251,7 @@ void ConvWS::initialize_instructions(Tile* tile, Mapping mapping) {
       .dest_addr = act_sp_base_addr,
       .size = (uint32_t)act_addr_set.size(),
       .src_addrs =
-          std::vector<addr_type>(act_addr_set.begin(), act_addr_set.end()),
+          AddressList(act_addr_set.begin(), act_addr_set.end()),
       .operand_id = _INPUT_OPERAND}));
   sram_allocation += act_addr_set.size();
   act_allocation += act_addr_set.size();
@@ -295,7 +295,7 @@ void ConvWS::initialize_instructions(Tile* tile, Mapping mapping) {
               .dest_addr = weight_sp_addr,
               .size = (uint32_t)weight_set.size(),
               .src_addrs =
-                  std::vector<addr_type>(weight_set.begin(), weight_set.end()),
+                  AddressList(weight_set.begin(), weight_set.end()),
               .operand_id = _INPUT_OPERAND + 1}));
           sram_allocation += weight_set.size();
         }
@@ -419,7 +419,7 @@ void ConvWS::initialize_instructions(Tile* tile, Mapping mapping) {
                   Instruction{.opcode = Opcode::MOVOUT_POOL,
                               .dest_addr = out_sp_addr,
                               .size = (uint32_t)out_dram_addrs.size(),
-                              .src_addrs = std::vector<addr_type>(
+                              .src_addrs = AddressList(
                                   out_dram_addrs.begin(), out_dram_addrs.end()),
                               .operand_id = _OUTPUT_OPERAND}));
             } else {
@@ -427,7 +427,7 @@ void ConvWS::initialize_instructions(Tile* tile, Mapping mapping) {
                   Instruction{.opcode = Opcode::MOVOUT,
                               .dest_addr = out_sp_addr,
                               .size = (uint32_t)out_dram_addrs.size(),
-                              .src_addrs = std::vector<addr_type>(
+                              .src_addrs = AddressList(
                                   out_dram_addrs.begin(), out_dram_addrs.end()),
                               .operand_id = _OUTPUT_OPERAND}));
             }
@@ -480,7 +480,7 @@ void ConvWS::initialize_matmul_instructions(Tile* tile) {
           .dest_addr = bias_sp_addr,
           .size = (uint32_t)skip_addrs.size() * n_loop,
           .src_addrs =
-              std::vector<addr_type>(skip_addrs.begin(), skip_addrs.end()),
+              AddressList(skip_addrs.begin(), skip_addrs.end()),
           .operand_id = _INPUT_OPERAND + 2}));
     }
   }
@@ -509,7 +509,7 @@ void ConvWS::initialize_matmul_instructions(Tile* tile) {
           .dest_addr = skip_sp_addr,
           .size = (uint32_t)skip_addrs.size(),
           .src_addrs =
-              std::vector<addr_type>(skip_addrs.begin(), skip_addrs.end()),
+              AddressList(skip_addrs.begin(), skip_addrs.end()),
           .operand_id = _INPUT_OPERAND + 3}));
     }
   }
@@ -546,7 +546,7 @@ void ConvWS::initialize_matmul_instructions(Tile* tile) {
               .dest_addr = act_sp_addr,
               .size = (uint32_t)act_addr.size(),
               .src_addrs =
-                  std::vector<addr_type>(act_addr.begin(), act_addr.end()),
+                  AddressList(act_addr.begin(), act_addr.end()),
               .operand_id = _INPUT_OPERAND}));
         }
 
@@ -565,7 +565,7 @@ void ConvWS::initialize_matmul_instructions(Tile* tile) {
               Instruction{.opcode = Opcode::MOVIN,
                           .dest_addr = weight_sp_addr,
                           .size = (uint32_t)weight_addr.size(),
-                          .src_addrs = std::vector<addr_type>(
+                          .src_addrs = AddressList(
                               weight_addr.begin(), weight_addr.end()),
                           .operand_id = _INPUT_OPERAND + 1}));
         }
@@ -585,7 +585,7 @@ void ConvWS::initialize_matmul_instructions(Tile* tile) {
               .dest_addr = out_sp_addr,
               .size = (uint32_t)out_addrs.size(),
               .src_addrs =
-                  std::vector<addr_type>(out_addrs.begin(), out_addrs.end()),
+                  AddressList(out_addrs.begin(), out_addrs.end()),
               .operand_id = _OUTPUT_OPERAND}));
         }
       }
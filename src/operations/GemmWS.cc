@@ -111,7 +111,7 @@ void GemmWS::initialize_instructions(Tile* tile, Mapping mapping) {
               .dest_addr = ACCUM_SPAD_BASE +
                           (Ns * mapping.tile_in_loop.M + Ms) * _config.precision,
               .size = (uint32_t)bias_addrs.size() * n_loop,
-              .src_addrs = std::vector<addr_type>(bias_addrs.begin(), bias_addrs.end()),
+              .src_addrs = AddressList(bias_addrs.begin(), bias_addrs.end()),
               .operand_id = _INPUT_OPERAND + 2}));
         } else {
           tile->instructions.push_back(std::make_unique<Instruction>(Instruction{
@@ -169,7 +169,7 @@ void GemmWS::initialize_instructions(Tile* tile, Mapping mapping) {
               .dest_addr = act_sp_addr,
               .size = (uint32_t)input_set.size(),
               .src_addrs =
-                  std::vector<addr_type>(input_set.begin(), input_set.end()),
+                  AddressList(input_set.begin(), input_set.end()),
               .operand_id = _INPUT_OPERAND,
               .tile_k = mapping.tile_in_loop.C,
               .tile_n = mapping.tile_in_loop.N}));
@@ -196,7 +196,7 @@ void GemmWS::initialize_instructions(Tile* tile, Mapping mapping) {
               .dest_addr = weight_sp_addr,
               .size = (uint32_t)weight_set.size(),
               .src_addrs =
-                  std::vector<addr_type>(weight_set.begin(), weight_set.end()),
+                  AddressList(weight_set.begin(), weight_set.end()),
               .operand_id = _INPUT_OPERAND + 1,
               .tile_m = mapping.tile_in_loop.M,
               .tile_k = mapping.tile_in_loop.C}));
@@ -237,7 +237,7 @@ void GemmWS::initialize_instructions(Tile* tile, Mapping mapping) {
               .dest_addr = out_sp_addr,
               .size = (uint32_t)output_set.size(),
               .src_addrs =
-                  std::vector<addr_type>(output_set.begin(), output_set.end()),
+                  AddressList(output_set.begin(), output_set.end()),
               .operand_id = _OUTPUT_OPERAND}));
         }
       }
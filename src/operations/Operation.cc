@@ -89,6 +89,28 @@ Operation::Operation(SimulationConfig config, Model* model,
   }
 }
 
+Operation::Operation(SimulationConfig config, Model* model, uint32_t id) {
+  _id = id;
+  _model = model;
+  _finish = false;
+  _config = config;
+  if (_config.layout == "NCHW") {
+    Ndim = 0;
+    Cdim = 1;
+    Hdim = 2;
+    Wdim = 3;
+  } else if (_config.layout == "NHWC") {
+    Ndim = 0;
+    Cdim = 3;
+    Hdim = 1;
+    Wdim = 2;
+  }
+  Mdim = 0;
+  Cdim_w = 1;
+  Sdim = 2;
+  Rdim = 3;
+}
+
 Operation::Operation(const Operation& operation) {
   spdlog::error("Opertion copy is not allowed !");
   exit(EXIT_FAILURE);
@@ -14,6 +14,7 @@ class Operation {
             uint32_t id);
   Operation(SimulationConfig config, MappingTable& mapping_table);
   Operation(SimulationConfig config, Model* model, onnx::NodeProto& node_proto);
+  Operation(SimulationConfig config, Model* model, uint32_t id);
   Operation(const Operation& operation);
   virtual ~Operation() = default;
   virtual void set_finish();
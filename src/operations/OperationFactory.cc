@@ -17,7 +17,7 @@
 // #include "MatMul.h"
 #include "MaxPool.h"
 
-SimulationConfig OperationFactory::_config = SimulationConfig();
+thread_local SimulationConfig OperationFactory::_config = SimulationConfig();
 
 void OperationFactory::initialize(SimulationConfig config) { _config = config; }
 
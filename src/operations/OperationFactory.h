@@ -11,5 +11,6 @@ class OperationFactory {
     static std::unique_ptr<Operation> copy_operation(Operation* op);
 
   private:
-    static SimulationConfig _config;
+    /* Per thread, so simulations of a sweep can use different configs */
+    static thread_local SimulationConfig _config;
 };
\ No newline at end of file
@@ -71,7 +71,7 @@ void SkipLayerNorm::initialize_instructions(Tile* tile, Mapping mapping, uint32_
         .opcode = Opcode::MOVIN,
         .dest_addr = sram_base,
         .size = (uint32_t)dram_addrs.size(),
-        .src_addrs = std::vector<addr_type>(dram_addrs.begin(), dram_addrs.end()),
+        .src_addrs = AddressList(dram_addrs.begin(), dram_addrs.end()),
         .operand_id = _INPUT_OPERAND,  // query
     }));
 
@@ -79,7 +79,7 @@ void SkipLayerNorm::initialize_instructions(Tile* tile, Mapping mapping, uint32_
         .opcode = Opcode::MOVIN,
         .dest_addr = sram_bias_base,
         .size = (uint32_t)dram_skip_addrs.size(),
-        .src_addrs = std::vector<addr_type>(dram_skip_addrs.begin(), dram_skip_addrs.end()),
+        .src_addrs = AddressList(dram_skip_addrs.begin(), dram_skip_addrs.end()),
         .operand_id = _INPUT_OPERAND+1,  // query
     }));
 
@@ -102,7 +102,7 @@ void SkipLayerNorm::initialize_instructions(Tile* tile, Mapping mapping, uint32_
         .opcode = Opcode::MOVOUT,
         .dest_addr = sram_base,
         .size = (uint32_t)dram_addrs.size(),
-        .src_addrs = std::vector<addr_type>(dram_addrs.begin(), dram_addrs.end()),
+        .src_addrs = AddressList(dram_addrs.begin(), dram_addrs.end()),
         .operand_id = _OUTPUT_OPERAND,
     }));
 }
@@ -72,7 +72,7 @@ void Softmax::initialize_instructions(Tile* tile, Mapping mapping, uint32_t toke
         .opcode = Opcode::MOVIN,
         .dest_addr = sram_base,
         .size = (uint32_t)dram_addrs.size(),
-        .src_addrs = std::vector<addr_type>(dram_addrs.begin(), dram_addrs.end()),
+        .src_addrs = AddressList(dram_addrs.begin(), dram_addrs.end()),
         .operand_id = _INPUT_OPERAND,  // query
     }));
 
@@ -88,7 +88,7 @@ void Softmax::initialize_instructions(Tile* tile, Mapping mapping, uint32_t toke
         .opcode = Opcode::MOVOUT,
         .dest_addr = sram_base,
         .size = (uint32_t)dram_addrs.size(),
-        .src_addrs = std::vector<addr_type>(dram_addrs.begin(), dram_addrs.end()),
+        .src_addrs = AddressList(dram_addrs.begin(), dram_addrs.end()),
         .operand_id = _OUTPUT_OPERAND,
     }));
 }
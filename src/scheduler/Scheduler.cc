@@ -15,6 +15,7 @@ Scheduler::Scheduler(SimulationConfig config, const cycle_type* core_cycle, cons
 
   for (int i=0; i<config.num_cores;i++)
     _core_executable_tile_queue[i] = std::deque<std::unique_ptr<Tile>>();
+  _stolen_tiles.resize(config.num_cores, 0);
 }
 
 void Scheduler::schedule_model(std::unique_ptr<Model> model,
@@ -70,6 +71,56 @@ void Scheduler::issue_tile_per_core() {
   }
 }
 
+/*
+ * Index of the last accumulation chain head in a queue. The chain from there
+ * to the tail has not started, so it can move to another core as a whole.
+ */
+static int last_chain_head(std::deque<std::unique_ptr<Tile>>& queue) {
+  for (int i = (int)queue.size() - 1; i >= 0; i--) {
+    if (!queue[i]->accum)
+      return i;
+  }
+  return -1;
+}
+
+/*
+ * Most loaded queue of a running core in the partition with an unstarted
+ * chain. The owner is busy with its current tile, so even its only queued
+ * chain waits; an idle owner is about to take its queue itself.
+ */
+int Scheduler::find_victim(uint32_t core_id, const std::function<bool(uint32_t)>& running) {
+  int victim = -1;
+  for (uint32_t other : _partition_map.at(cpu_to_partition(core_id))) {
+    if (other == core_id || !running(other) ||
+        last_chain_head(_core_executable_tile_queue[other]) < 0)
+      continue;
+    if (victim < 0 ||
+        _core_executable_tile_queue[other].size() > _core_executable_tile_queue[victim].size())
+      victim = other;
+  }
+  return victim;
+}
+
+bool Scheduler::steal_tiles(uint32_t core_id, const std::function<bool(uint32_t)>& running) {
+  if (!_core_executable_tile_queue[core_id].empty())
+    return false;
+  int victim = find_victim(core_id, running);
+  if (victim < 0)
+    return false;
+  std::deque<std::unique_ptr<Tile>>& from = _core_executable_tile_queue[victim];
+  std::deque<std::unique_ptr<Tile>>& to = _core_executable_tile_queue[core_id];
+  int head = last_chain_head(from);
+  for (int i = head; i < from.size(); i++) {
+    from[i]->core_id = core_id;
+    to.push_back(std::move(from[i]));
+  }
+  spdlog::debug("Core {} steals {} tiles from core {} at {}", core_id, from.size() - head,
+                victim, *_core_cycle);
+  _stolen_tiles[core_id] += from.size() - head;
+  from.erase(from.begin() + head, from.end());
+  return true;
+}
+
 /*TODO: Add base address for each addr in tiles */
 std::unique_ptr<Tile> Scheduler::get_tile(uint32_t core_id) {
   uint32_t partition_id = cpu_to_partition(core_id);
@@ -154,7 +205,8 @@ void Scheduler::finish_tile(uint32_t core_id, int layer_id) {
                  _active_layers_map[layer_id].name, *_core_cycle);
     spdlog::info("Total compute time {}",
                  *_core_cycle - _active_layers_map[layer_id].start_cycle);
-    _request_queue.front().model->set_layer_finish(layer_id);
+    _request_queue.front().model->set_layer_finish(
+        layer_id, *_core_cycle - _active_layers_map[layer_id].start_cycle);
     _layer_stat_map[layer_id] = _active_layers_map[layer_id];
     _active_layers_map.erase(layer_id);
   }
@@ -163,6 +215,20 @@ void Scheduler::finish_tile(uint32_t core_id, int layer_id) {
 
 bool Scheduler::empty() { return _request_queue.empty(); }
 
+/* True if get_tile(core_id) would return an empty tile without changing state */
+bool Scheduler::can_fast_forward(uint32_t core_id) {
+  uint32_t partition_id = cpu_to_partition(core_id);
+  if (!_core_executable_tile_queue[core_id].empty())
+    return false;
+  if (_executable_tile_queue[partition_id].empty())
+    return count_active_layers() > 0;
+  std::unique_ptr<Tile>& tile = _executable_tile_queue[partition_id].front();
+  if (tile->status != Tile::Status::BAR)
+    return false;
+  LayerStat& stat = _active_layers_map[tile->layer_id];
+  return stat.launched_tiles != stat.finished_tiles;
+}
+
 void Scheduler::refresh_status() {
   if (!_request_queue.empty()) {
     if (_request_queue.front().model->check_finish()) {
@@ -171,6 +237,7 @@ void Scheduler::refresh_status() {
                     _request_queue.front().model->get_request_time() / 1000000,
                     _request_queue.front().model->get_start_time() / 1000000,
                     (*_core_time) / 1000000, *_core_cycle);
+      finish_model(_request_queue.front());
       _request_queue.pop_front();
     }
   }
@@ -198,7 +265,9 @@ void Scheduler::refresh_status() {
     _nr_layer++;
     _active_layers_map[new_layer->get_id()] =
         LayerStat{.id = new_layer->get_id(),
+                  .request_id = _request_queue.front().request_id,
                   .name = new_layer->get_name(),
+                  .optype = new_layer->get_optype(),
                   .launched = true,
                   .start_cycle = *_core_cycle,
                   .total_tiles = (uint32_t)_executable_tile_queue[0].size(),
@@ -211,6 +280,135 @@ void Scheduler::refresh_status() {
   }
 }
 
+void Scheduler::finish_model(Request& request) {
+  Model* model = request.model.get();
+  uint64_t core_period = 1000000 / _config.core_freq;
+  _model_stats.push_back(ModelStat{.request_id = request.request_id,
+                                   .name = model->get_name(),
+                                   .request_time = model->get_request_time(),
+                                   .start_time = model->get_start_time(),
+                                   .finish_time = *_core_time,
+                                   .finish_cycle = *_core_cycle,
+                                   .total_cycles = (*_core_time - model->get_request_time()) / core_period,
+                                   .slo = model->get_slo()});
+}
+
+void Scheduler::checkpoint(ModelCache::Writer& writer) {
+  writer.write(_core_rr_id);
+  writer.write(_nr_layer);
+  writer.write<uint32_t>(_request_queue.size());
+  for (auto& request : _request_queue) {
+    writer.write(request.model->get_root_id());
+    writer.write(request.request_id);
+    writer.write(request.sample_size);
+    request.model->checkpoint(writer);
+  }
+  for (auto* queues : {&_executable_tile_queue, &_core_executable_tile_queue}) {
+    writer.write<uint32_t>(queues->size());
+    for (auto& [id, tiles] : *queues) {
+      writer.write(id);
+      writer.write_tiles(tiles);
+    }
+  }
+  write_layer_stats(writer, _layer_stat_map);
+  write_layer_stats(writer, _active_layers_map);
+  writer.write<uint32_t>(_model_stats.size());
+  for (auto& stat : _model_stats) {
+    writer.write(stat.request_id);
+    writer.write(stat.name);
+    writer.write(stat.request_time);
+    writer.write(stat.start_time);
+    writer.write(stat.finish_time);
+    writer.write(stat.finish_cycle);
+    writer.write(stat.total_cycles);
+    writer.write(stat.slo);
+  }
+  for (uint64_t stolen : _stolen_tiles)
+    writer.write(stolen);
+}
+
+void Scheduler::restore(ModelCache::Reader& reader,
+                        std::vector<std::unique_ptr<Model>>& launched_models) {
+  _core_rr_id = reader.read<int>();
+  _nr_layer = reader.read<uint32_t>();
+  uint32_t num_requests = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < num_requests; i++) {
+    uint32_t root_id = reader.read<uint32_t>();
+    auto it = std::find_if(launched_models.begin(), launched_models.end(),
+                           [root_id](auto& model) { return model && model->get_root_id() == root_id; });
+    if (it == launched_models.end())
+      throw std::runtime_error(fmt::format("Checkpointed model {} is not registered", root_id));
+    Request request{.request_id = reader.read<uint32_t>(), .model = std::move(*it)};
+    request.sample_size = reader.read<uint32_t>();
+    request.model->restore(reader);
+    _request_queue.push_back(std::move(request));
+  }
+  for (auto* queues : {&_executable_tile_queue, &_core_executable_tile_queue}) {
+    queues->clear();
+    uint32_t num_queues = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < num_queues; i++) {
+      uint32_t id = reader.read<uint32_t>();
+      reader.read_tiles((*queues)[id], ModelCache::Relocation());
+    }
+  }
+  read_layer_stats(reader, _layer_stat_map);
+  read_layer_stats(reader, _active_layers_map);
+  _model_stats.resize(reader.read<uint32_t>());
+  for (auto& stat : _model_stats) {
+    stat.request_id = reader.read<uint32_t>();
+    stat.name = reader.read_string();
+    stat.request_time = reader.read<uint64_t>();
+    stat.start_time = reader.read<uint64_t>();
+    stat.finish_time = reader.read<uint64_t>();
+    stat.finish_cycle = reader.read<uint64_t>();
+    stat.total_cycles = reader.read<uint64_t>();
+    stat.slo = reader.read<uint64_t>();
+  }
+  for (uint64_t& stolen : _stolen_tiles)
+    stolen = reader.read<uint64_t>();
+}
+
+void Scheduler::write_layer_stats(ModelCache::Writer& writer,
+                                  robin_hood::unordered_map<uint32_t, LayerStat>& layer_stats) {
+  writer.write<uint32_t>(layer_stats.size());
+  for (auto& [id, stat] : layer_stats) {
+    writer.write(id);
+    writer.write(stat.id);
+    writer.write(stat.request_id);
+    writer.write(stat.name);
+    writer.write(stat.optype);
+    writer.write(stat.launched);
+    writer.write(stat.start_cycle);
+    writer.write(stat.finish_cycle);
+    writer.write(stat.memory_stall_cycle);
+    writer.write(stat.total_tiles);
+    writer.write(stat.remain_tiles);
+    writer.write(stat.finished_tiles);
+    writer.write(stat.launched_tiles);
+  }
+}
+
+void Scheduler::read_layer_stats(ModelCache::Reader& reader,
+                                 robin_hood::unordered_map<uint32_t, LayerStat>& layer_stats) {
+  layer_stats.clear();
+  uint32_t num_stats = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < num_stats; i++) {
+    LayerStat& stat = layer_stats[reader.read<uint32_t>()];
+    stat.id = reader.read<uint32_t>();
+    stat.request_id = reader.read<uint32_t>();
+    stat.name = reader.read_string();
+    stat.optype = reader.read_string();
+    stat.launched = reader.read<bool>();
+    stat.start_cycle = reader.read<cycle_type>();
+    stat.finish_cycle = reader.read<cycle_type>();
+    stat.memory_stall_cycle = reader.read<cycle_type>();
+    stat.total_tiles = reader.read<uint32_t>();
+    stat.remain_tiles = reader.read<uint32_t>();
+    stat.finished_tiles = reader.read<uint32_t>();
+    stat.launched_tiles = reader.read<uint32_t>();
+  }
+}
+
 uint32_t Scheduler::count_active_layers() {
   uint32_t count = 0;
   count = _active_layers_map.size();
@@ -221,6 +419,27 @@ DedicatedCPUScheduler::DedicatedCPUScheduler(SimulationConfig config,
                                        const cycle_type* core_cycle, const uint64_t* core_time)
     : TimeMultiplexScheduler(config, core_cycle, core_time) {}
 
+bool DedicatedCPUScheduler::can_fast_forward(uint32_t core_id) {
+  /* refresh_status() may pull a new layer for any core with an empty queue */
+  for (int i = 0; i < _config.num_cores; i++) {
+    if (_core_executable_tile_queue[i].empty() &&
+        _executable_tile_queue[cpu_to_partition(i)].empty())
+      return false;
+  }
+  return Scheduler::can_fast_forward(core_id);
+}
+
+void DedicatedCPUScheduler::checkpoint(ModelCache::Writer& writer) {
+  TimeMultiplexScheduler::checkpoint(writer);
+  writer.write(_request_rr);
+}
+
+void DedicatedCPUScheduler::restore(ModelCache::Reader& reader,
+                                    std::vector<std::unique_ptr<Model>>& launched_models) {
+  TimeMultiplexScheduler::restore(reader, launched_models);
+  _request_rr = reader.read<uint32_t>();
+}
+
 void DedicatedCPUScheduler::refresh_status() {
   if (!_request_queue.empty()) {
     for (auto req = _request_queue.begin(); req != _request_queue.end();
@@ -231,6 +450,7 @@ void DedicatedCPUScheduler::refresh_status() {
                       req->model->get_request_time()/1000000,
                       req->model->get_start_time()/1000000,
                       (*_core_time)/1000000, *_core_cycle);
+        finish_model(*req);
         req = _request_queue.erase(req);
         --req;
       }
@@ -291,6 +511,7 @@ void DedicatedCPUScheduler::refresh_status() {
             LayerStat{.id = new_layer->get_id(),
                       .request_id = _request_queue[req_index].request_id,
                       .name = new_layer->get_name(),
+                      .optype = new_layer->get_optype(),
                       .launched = true,
                       .start_cycle = *_core_cycle,
                       .total_tiles = (uint32_t)_executable_tile_queue[partition_id].size(),
@@ -312,6 +533,24 @@ TimeMultiplexScheduler::TimeMultiplexScheduler(SimulationConfig config,
                                        const cycle_type* core_cycle, const uint64_t* core_time)
     : Scheduler(config, core_cycle, core_time) {}
 
+bool TimeMultiplexScheduler::can_fast_forward(uint32_t core_id) {
+  /* refresh_status() rotates the request pointer whenever queues are empty */
+  if (tile_queue_empty())
+    return false;
+  return Scheduler::can_fast_forward(core_id);
+}
+
+void TimeMultiplexScheduler::checkpoint(ModelCache::Writer& writer) {
+  Scheduler::checkpoint(writer);
+  writer.write(_request_rr);
+}
+
+void TimeMultiplexScheduler::restore(ModelCache::Reader& reader,
+                                     std::vector<std::unique_ptr<Model>>& launched_models) {
+  Scheduler::restore(reader, launched_models);
+  _request_rr = reader.read<uint32_t>();
+}
+
 void TimeMultiplexScheduler::finish_tile(uint32_t core_id, int layer_id) {
   spdlog::debug("Layer {} Core {} Finish Tile at {} Remain tile {}", layer_id, core_id,
                 *_core_cycle, _active_layers_map[layer_id].remain_tiles);
@@ -328,7 +567,8 @@ void TimeMultiplexScheduler::finish_tile(uint32_t core_id, int layer_id) {
       if (_request_queue[req_index].request_id ==
           _active_layers_map[layer_id].request_id) {
         model_finish = true;
-        _request_queue[req_index].model->set_layer_finish(layer_id);
+        _request_queue[req_index].model->set_layer_finish(
+            layer_id, *_core_cycle - _active_layers_map[layer_id].start_cycle);
         model_name = _request_queue[req_index].model->get_name();
       }
     }
@@ -353,6 +593,7 @@ void TimeMultiplexScheduler::refresh_status() {
                       req->model->get_request_time()/1000000,
                       req->model->get_start_time()/1000000,
                       (*_core_time)/1000000, *_core_cycle);
+        finish_model(*req);
         req = _request_queue.erase(req);
         --req;
       }
@@ -360,9 +601,11 @@ void TimeMultiplexScheduler::refresh_status() {
   }
   bool all_empty = tile_queue_empty();
   if (!_request_queue.empty() && all_empty) {
-    _request_rr = (_request_rr + 1) % _request_queue.size();
+    int req_index = select_request();
+    if (req_index < 0)
+      return;
     Operation* new_layer =
-        _request_queue[_request_rr].model->get_executable_tile();
+        _request_queue[req_index].model->get_executable_tile();
     /* Check executable layer exist */
     if (new_layer == nullptr)
       return;
@@ -376,7 +619,7 @@ void TimeMultiplexScheduler::refresh_status() {
         spdlog::info("Layer {} {}: Enqueue", new_layer->get_name(),
                      new_layer->get_id());
 
-      _request_queue[_request_rr].model->update_start_time(*_core_time);
+      _request_queue[req_index].model->update_start_time(*_core_time);
       _executable_tile_queue[0].insert(
         _executable_tile_queue[0].end(),
         std::make_move_iterator(new_layer->get_tiles().begin()),
@@ -385,8 +628,9 @@ void TimeMultiplexScheduler::refresh_status() {
       _nr_layer++;
       _active_layers_map[new_layer->get_id()] =
           LayerStat{.id = new_layer->get_id(),
-                    .request_id = _request_queue[_request_rr].request_id,
+                    .request_id = _request_queue[req_index].request_id,
                     .name = new_layer->get_name(),
+                    .optype = new_layer->get_optype(),
                     .launched = true,
                     .start_cycle = *_core_cycle,
                     .total_tiles = (uint32_t)_executable_tile_queue[0].size(),
@@ -400,6 +644,29 @@ void TimeMultiplexScheduler::refresh_status() {
   }
 }
 
+/* Round robin over the requests, whether or not the next one has a layer ready */
+int TimeMultiplexScheduler::select_request() {
+  _request_rr = (_request_rr + 1) % _request_queue.size();
+  return _request_rr;
+}
+
+DeadlineScheduler::DeadlineScheduler(SimulationConfig config, const cycle_type* core_cycle,
+                                     const uint64_t* core_time)
+    : TimeMultiplexScheduler(config, core_cycle, core_time) {}
+
+/* Earliest deadline among the requests with an executable layer, oldest first on ties */
+int DeadlineScheduler::select_request() {
+  int selected = -1;
+  for (int req_index = 0; req_index < _request_queue.size(); req_index++) {
+    Model* model = _request_queue[req_index].model.get();
+    if (!model->executable_layer_size())
+      continue;
+    if (selected < 0 || model->get_deadline() < _request_queue[selected].model->get_deadline())
+      selected = req_index;
+  }
+  return selected;
+}
+
 HalfSplitScheduler::HalfSplitScheduler(SimulationConfig config,
                                        const cycle_type* core_cycle, const uint64_t* core_time)
     : Scheduler(config, core_cycle, core_time) {}
@@ -435,6 +702,32 @@ std::unique_ptr<Tile> HalfSplitScheduler::get_tile(uint32_t core_id) {
   }
 }
 
+void HalfSplitScheduler::checkpoint(ModelCache::Writer& writer) {
+  Scheduler::checkpoint(writer);
+  writer.write<uint32_t>(_executable_tile_queue_table.size());
+  for (auto& [request_id, tiles] : _executable_tile_queue_table) {
+    writer.write(request_id);
+    writer.write_tiles(tiles);
+  }
+}
+
+void HalfSplitScheduler::restore(ModelCache::Reader& reader,
+                                 std::vector<std::unique_ptr<Model>>& launched_models) {
+  Scheduler::restore(reader, launched_models);
+  _executable_tile_queue_table.clear();
+  uint32_t num_queues = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < num_queues; i++) {
+    uint32_t request_id = reader.read<uint32_t>();
+    reader.read_tiles(_executable_tile_queue_table[request_id], ModelCache::Relocation());
+  }
+}
+
+bool HalfSplitScheduler::can_fast_forward(uint32_t core_id) {
+  uint32_t target_id = core_id % _request_queue.size();
+  uint32_t req_id = _request_queue[target_id].request_id;
+  return _executable_tile_queue_table[req_id].empty();
+}
+
 void HalfSplitScheduler::finish_tile(uint32_t core_id, int layer_id) {
   assert(_active_layers_map.find(layer_id) != _active_layers_map.end());
   assert(_active_layers_map[layer_id].remain_tiles > 0);
@@ -449,7 +742,8 @@ void HalfSplitScheduler::finish_tile(uint32_t core_id, int layer_id) {
       if (_request_queue[req_index].request_id ==
           _active_layers_map[layer_id].request_id) {
         model_finish = true;
-        _request_queue[req_index].model->set_layer_finish(layer_id);
+        _request_queue[req_index].model->set_layer_finish(
+            layer_id, *_core_cycle - _active_layers_map[layer_id].start_cycle);
         model_name = _request_queue[req_index].model->get_name();
         _executable_tile_queue_table.erase(
             _request_queue[req_index].request_id);
@@ -473,6 +767,7 @@ void HalfSplitScheduler::refresh_status() {
       if (req->model->check_finish()) {
         spdlog::info("Model[{}] finish  at {}", req->model->get_name(),
                      *_core_cycle);
+        finish_model(*req);
         req = _request_queue.erase(req);
         --req;
       }
@@ -504,6 +799,7 @@ void HalfSplitScheduler::refresh_status() {
               LayerStat{.id = new_layer->get_id(),
                         .request_id = req->request_id,
                         .name = new_layer->get_name(),
+                        .optype = new_layer->get_optype(),
                         .launched = false,
                         .start_cycle = *_core_cycle,
                         .total_tiles = (uint32_t)_executable_tile_queue_table[req->request_id].size(),
@@ -515,3 +811,190 @@ void HalfSplitScheduler::refresh_status() {
     }
   }
 }
+
+LayerParallelScheduler::LayerParallelScheduler(SimulationConfig config,
+                                               const cycle_type* core_cycle, const uint64_t* core_time)
+    : Scheduler(config, core_cycle, core_time) {}
+
+std::unique_ptr<Tile> LayerParallelScheduler::get_tile(uint32_t core_id) {
+  if (_core_executable_tile_queue[core_id].empty())
+    refresh_status();
+  if (_core_executable_tile_queue[core_id].empty())
+    return std::make_unique<Tile>(Tile{.status = Tile::Status::EMPTY});
+
+  std::unique_ptr<Tile> tile = std::move(_core_executable_tile_queue[core_id].front());
+  _core_executable_tile_queue[core_id].pop_front();
+  _active_layers_map[tile->layer_id].launched_tiles++;
+  spdlog::debug("Layer {} Core {} Get Tile at {}", _active_layers_map[tile->layer_id].name, core_id,
+                *_core_cycle);
+  return tile;
+}
+
+void LayerParallelScheduler::finish_tile(uint32_t core_id, int layer_id) {
+  spdlog::debug("Layer {} Core {} Finish Tile at {} Remain tile {}", layer_id, core_id,
+                *_core_cycle, _active_layers_map[layer_id].remain_tiles);
+  assert(_active_layers_map.find(layer_id) != _active_layers_map.end());
+  assert(_active_layers_map[layer_id].remain_tiles > 0);
+  _active_layers_map[layer_id].remain_tiles--;
+  _active_layers_map[layer_id].finished_tiles++;
+  if (_active_layers_map[layer_id].remain_tiles == 0)
+    finish_layer(layer_id);
+  refresh_status();
+}
+
+bool LayerParallelScheduler::tile_queue_empty() {
+  for (auto& [layer_id, tiles] : _layer_tile_queues) {
+    if (!tiles.empty())
+      return false;
+  }
+  for (auto& [core_id, tiles] : _core_executable_tile_queue) {
+    if (!tiles.empty())
+      return false;
+  }
+  return true;
+}
+
+/* Barriers are released as soon as the tile before them finishes, so only a
+ * layer launch can hand an idle core new work */
+bool LayerParallelScheduler::can_fast_forward(uint32_t core_id) {
+  if (!_core_executable_tile_queue[core_id].empty())
+    return false;
+  return !(can_launch_layer() && _request_queue.front().model->executable_layer_size() > 0);
+}
+
+void LayerParallelScheduler::checkpoint(ModelCache::Writer& writer) {
+  Scheduler::checkpoint(writer);
+  writer.write<uint32_t>(_layer_tile_queues.size());
+  for (auto& [layer_id, tiles] : _layer_tile_queues) {
+    writer.write(layer_id);
+    writer.write_tiles(tiles);
+  }
+}
+
+void LayerParallelScheduler::restore(ModelCache::Reader& reader,
+                                     std::vector<std::unique_ptr<Model>>& launched_models) {
+  Scheduler::restore(reader, launched_models);
+  _layer_tile_queues.clear();
+  uint32_t num_queues = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < num_queues; i++) {
+    uint32_t layer_id = reader.read<uint32_t>();
+    reader.read_tiles(_layer_tile_queues[layer_id], ModelCache::Relocation());
+  }
+}
+
+void LayerParallelScheduler::refresh_status() {
+  if (!_request_queue.empty() && _request_queue.front().model->check_finish()) {
+    spdlog::info("Model[{}] Request: {} us, Start: {} us, finish:{} us, Current Cycle:{}",
+                  _request_queue.front().model->get_name(),
+                  _request_queue.front().model->get_request_time() / 1000000,
+                  _request_queue.front().model->get_start_time() / 1000000,
+                  (*_core_time) / 1000000, *_core_cycle);
+    finish_model(_request_queue.front());
+    _request_queue.pop_front();
+  }
+  release_barriers();
+  while (can_launch_layer()) {
+    Operation* new_layer = _request_queue.front().model->get_executable_tile();
+    if (new_layer == nullptr)
+      break;
+    launch_layer(new_layer);
+  }
+}
+
+/* The first layer always starts; later ones only while some core is idle */
+bool LayerParallelScheduler::can_launch_layer() {
+  if (_request_queue.empty() || count_active_layers() >= _config.max_active_layers)
+    return false;
+  if (count_active_layers() == 0)
+    return true;
+  for (auto& [core_id, tiles] : _core_executable_tile_queue) {
+    if (tiles.empty())
+      return true;
+  }
+  return false;
+}
+
+void LayerParallelScheduler::launch_layer(Operation* layer) {
+  if (count_active_layers() > 0)
+    spdlog::info("Layer {} {}: launched before finish prior layer", layer->get_name(),
+                 layer->get_id());
+  else
+    spdlog::info("Start layer {}", layer->get_name().c_str());
+  _request_queue.front().model->update_start_time(*_core_time);
+  std::deque<std::unique_ptr<Tile>>& tiles = _layer_tile_queues[layer->get_id()];
+  tiles.insert(tiles.end(), std::make_move_iterator(layer->get_tiles().begin()),
+               std::make_move_iterator(layer->get_tiles().end()));
+  layer->clear_tiles();
+
+  _nr_layer++;
+  _active_layers_map[layer->get_id()] =
+      LayerStat{.id = layer->get_id(),
+                .request_id = _request_queue.front().request_id,
+                .name = layer->get_name(),
+                .optype = layer->get_optype(),
+                .launched = true,
+                .start_cycle = *_core_cycle,
+                .total_tiles = (uint32_t)tiles.size(),
+                .remain_tiles = (uint32_t)tiles.size(),
+                .finished_tiles = 0,
+                .launched_tiles = 0};
+  issue_layer_tiles(tiles);
+}
+
+/*
+ * Hands the tiles up to the next barrier to the cores with the fewest queued
+ * tiles. An accumulating tile follows the tile before it, so each output
+ * tile's chain stays on one core and in order.
+ */
+void LayerParallelScheduler::issue_layer_tiles(std::deque<std::unique_ptr<Tile>>& tiles) {
+  int chain_core = -1;
+  while (!tiles.empty() && tiles.front()->status != Tile::Status::BAR) {
+    std::unique_ptr<Tile> tile = std::move(tiles.front());
+    tiles.pop_front();
+    if (!tile->accum || chain_core < 0) {
+      chain_core = _core_rr_id % _config.num_cores;
+      for (int i = 1; i < _config.num_cores; i++) {
+        int core_id = (_core_rr_id + i) % _config.num_cores;
+        if (_core_executable_tile_queue[core_id].size() <
+            _core_executable_tile_queue[chain_core].size())
+          chain_core = core_id;
+      }
+      _core_rr_id++;
+    }
+    tile->core_id = chain_core;
+    _core_executable_tile_queue[chain_core].push_back(std::move(tile));
+  }
+}
+
+/* A barrier passes once every tile launched before it has finished */
+void LayerParallelScheduler::release_barriers() {
+  std::vector<uint32_t> finished_layers;
+  for (auto& [layer_id, tiles] : _layer_tile_queues) {
+    if (tiles.empty() || tiles.front()->status != Tile::Status::BAR)
+      continue;
+    LayerStat& stat = _active_layers_map[layer_id];
+    if (stat.launched_tiles != stat.finished_tiles)
+      continue;
+    tiles.pop_front();
+    stat.launched_tiles++;
+    stat.finished_tiles++;
+    stat.remain_tiles--;
+    if (stat.remain_tiles == 0)
+      finished_layers.push_back(layer_id);
+    else
+      issue_layer_tiles(tiles);
+  }
+  for (uint32_t layer_id : finished_layers)
+    finish_layer(layer_id);
+}
+
+void LayerParallelScheduler::finish_layer(uint32_t layer_id) {
+  LayerStat& stat = _active_layers_map[layer_id];
+  stat.finish_cycle = *_core_cycle;
+  spdlog::info("Layer {} finish at {}", stat.name, *_core_cycle);
+  spdlog::info("Total compute time {}", *_core_cycle - stat.start_cycle);
+  _request_queue.front().model->set_layer_finish(layer_id, *_core_cycle - stat.start_cycle);
+  _layer_stat_map[layer_id] = stat;
+  _active_layers_map.erase(layer_id);
+  _layer_tile_queues.erase(layer_id);
+}
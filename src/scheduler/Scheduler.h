@@ -1,5 +1,6 @@
 #pragma once
 #include <robin_hood.h>
+#include <functional>
 #include "../Common.h"
 #include "../Model.h"
 
@@ -20,11 +21,16 @@ class Scheduler {
     virtual void finish_tile(uint32_t core_id, int layer_id);
     virtual bool empty();
     virtual bool tile_queue_empty();
-  protected:
+    virtual bool can_fast_forward(uint32_t core_id);
+    /* Queued tiles, layer progress and the launched models still running */
+    virtual void checkpoint(ModelCache::Writer& writer);
+    virtual void restore(ModelCache::Reader& reader,
+                         std::vector<std::unique_ptr<Model>>& launched_models);
     typedef struct {
       uint32_t id;
       uint32_t request_id;
       std::string name;
+      std::string optype;
       bool launched;
       cycle_type start_cycle;
       cycle_type finish_cycle;
@@ -34,6 +40,25 @@ class Scheduler {
       uint32_t finished_tiles;
       uint32_t launched_tiles;
     } LayerStat;
+    /* Finished layers by id */
+    const robin_hood::unordered_map<uint32_t, LayerStat>& get_layer_stats() {
+      return _layer_stat_map;
+    }
+    /* Finished models by finish time; op_stats are left to the caller */
+    const std::vector<ModelStat>& get_model_stats() { return _model_stats; }
+    /*
+     * Work stealing for a core with nothing running: moves the last unstarted
+     * accumulation chain of the most loaded running core in its partition to
+     * the core's empty queue, so partial sums never split across cores.
+     */
+    bool steal_tiles(uint32_t core_id, const std::function<bool(uint32_t)>& running);
+    bool can_steal(uint32_t core_id, const std::function<bool(uint32_t)>& running) {
+      return _core_executable_tile_queue[core_id].empty() && find_victim(core_id, running) >= 0;
+    }
+    /* Tiles the core took from other cores' queues with work_stealing */
+    uint64_t get_stolen_tiles(uint32_t core_id) { return _stolen_tiles[core_id]; }
+
+  protected:
 
     int _core_rr_id = 0;
     const cycle_type* _core_cycle;
@@ -47,25 +72,59 @@ class Scheduler {
     SimulationConfig _config;
     robin_hood::unordered_map<uint32_t, LayerStat> _layer_stat_map;
     robin_hood::unordered_map<uint32_t, LayerStat> _active_layers_map;
+    std::vector<ModelStat> _model_stats;
+    std::vector<uint64_t> _stolen_tiles;
     virtual void refresh_status();
+    void finish_model(Request& request);
+    void write_layer_stats(ModelCache::Writer& writer,
+                           robin_hood::unordered_map<uint32_t, LayerStat>& layer_stats);
+    void read_layer_stats(ModelCache::Reader& reader,
+                          robin_hood::unordered_map<uint32_t, LayerStat>& layer_stats);
     uint32_t count_active_layers();
     uint32_t cpu_to_partition(uint32_t cpu);
+    int find_victim(uint32_t core_id, const std::function<bool(uint32_t)>& running);
 };
 
 class TimeMultiplexScheduler : public Scheduler {
   public:
     TimeMultiplexScheduler(SimulationConfig config, const cycle_type* core_cycle, const uint64_t* core_time);
     virtual void finish_tile(uint32_t core_id, int layer_id) override ;
+    virtual bool can_fast_forward(uint32_t core_id) override;
+    virtual void checkpoint(ModelCache::Writer& writer) override;
+    virtual void restore(ModelCache::Reader& reader,
+                         std::vector<std::unique_ptr<Model>>& launched_models) override;
   
   protected:
     virtual void refresh_status() override;
+    /* Request whose next layer is launched once the tile queues drain, -1 for none */
+    virtual int select_request();
   private:
     uint32_t _request_rr=0;
 };
 
+/*
+ * Earliest deadline first across tenants (edf). A model's deadline is its
+ * request time plus the slo of its models list entry; models without an slo
+ * run after all that have one, oldest first. As with time_multiplex a layer
+ * is launched whenever the tile queues drain, so a request with an earlier
+ * deadline preempts the running ones at their next layer boundary while the
+ * tiles already issued run to completion.
+ */
+class DeadlineScheduler : public TimeMultiplexScheduler {
+  public:
+    DeadlineScheduler(SimulationConfig config, const cycle_type* core_cycle, const uint64_t* core_time);
+
+  protected:
+    virtual int select_request() override;
+};
+
 class DedicatedCPUScheduler: public TimeMultiplexScheduler {
   public:
     DedicatedCPUScheduler(SimulationConfig config, const cycle_type* core_cycle, const uint64_t* core_time);
+    virtual bool can_fast_forward(uint32_t core_id) override;
+    virtual void checkpoint(ModelCache::Writer& writer) override;
+    virtual void restore(ModelCache::Reader& reader,
+                         std::vector<std::unique_ptr<Model>>& launched_models) override;
 
   protected:
     virtual void refresh_status() override;
@@ -79,8 +138,44 @@ class HalfSplitScheduler : public Scheduler {
     virtual void schedule_model(std::unique_ptr<Model> model, uint32_t sampe_size) override;
     virtual std::unique_ptr<Tile> get_tile(uint32_t core_id) override;
     virtual void finish_tile(uint32_t core_id, int layer_id) override ;
-    
+    virtual bool can_fast_forward(uint32_t core_id) override;
+    virtual void checkpoint(ModelCache::Writer& writer) override;
+    virtual void restore(ModelCache::Reader& reader,
+                         std::vector<std::unique_ptr<Model>>& launched_models) override;
+
   protected:
     virtual void refresh_status() override;
     robin_hood::unordered_map<uint32_t, std::deque<std::unique_ptr<Tile>>> _executable_tile_queue_table;
 };
+
+/*
+ * Keeps up to max_active_layers executable layers of the front request in
+ * flight, so independent branches of the graph (parallel projections,
+ * residual side paths) overlap and the tail of one layer is filled with tiles
+ * of the next. A new layer is launched whenever a core runs out of queued
+ * tiles. Dependencies are those of Model's executable layers, and each core
+ * still runs one tile at a time in its own scratchpad.
+ */
+class LayerParallelScheduler : public Scheduler {
+  public:
+    LayerParallelScheduler(SimulationConfig config, const cycle_type* core_cycle, const uint64_t* core_time);
+    virtual std::unique_ptr<Tile> get_tile(uint32_t core_id) override;
+    virtual void finish_tile(uint32_t core_id, int layer_id) override;
+    virtual bool tile_queue_empty() override;
+    virtual bool can_fast_forward(uint32_t core_id) override;
+    virtual void checkpoint(ModelCache::Writer& writer) override;
+    virtual void restore(ModelCache::Reader& reader,
+                         std::vector<std::unique_ptr<Model>>& launched_models) override;
+
+  protected:
+    virtual void refresh_status() override;
+
+  private:
+    bool can_launch_layer();
+    void launch_layer(Operation* layer);
+    void issue_layer_tiles(std::deque<std::unique_ptr<Tile>>& tiles);
+    void release_barriers();
+    void finish_layer(uint32_t layer_id);
+    /* Tiles of each active layer not yet given to a core, up to its next barrier */
+    std::map<uint32_t, std::deque<std::unique_ptr<Tile>>> _layer_tile_queues;
+};
@@ -0,0 +1,42 @@
+#include "Common.h"
+#include "gtest/gtest.h"
+
+static std::vector<addr_type> expand(const AddressList& list) {
+  std::vector<addr_type> addrs;
+  for (addr_type addr : list)
+    addrs.push_back(addr);
+  return addrs;
+}
+
+TEST(AddressListContiguousTest, BasicAssertions) {
+  std::vector<addr_type> addrs;
+  for (addr_type addr = 0x1000; addr < 0x1000 + 64 * 32; addr += 32)
+    addrs.push_back(addr);
+  AddressList list(addrs.begin(), addrs.end());
+  ASSERT_EQ(list.size(), addrs.size());
+  ASSERT_EQ(list.num_runs(), 1);
+  ASSERT_EQ(expand(list), addrs);
+}
+
+TEST(AddressListBlockTest, BasicAssertions) {
+  /* 16 rows of 4 atoms with a 1KB row pitch, then a partial row */
+  std::vector<addr_type> addrs;
+  for (addr_type row = 0; row < 16; row++)
+    for (addr_type col = 0; col < 4; col++)
+      addrs.push_back(row * 1024 + col * 32);
+  addrs.push_back(16 * 1024);
+  addrs.push_back(16 * 1024 + 32);
+  AddressList list(addrs.begin(), addrs.end());
+  ASSERT_EQ(list.num_runs(), 1);
+  ASSERT_EQ(expand(list), addrs);
+}
+
+TEST(AddressListIrregularTest, BasicAssertions) {
+  std::vector<addr_type> addrs = {0, 32, 64, 4096, 4128, 4160, 4192, 10000, 7, 7, 3};
+  AddressList list(addrs);
+  ASSERT_EQ(list.size(), addrs.size());
+  ASSERT_EQ(expand(list), addrs);
+  ASSERT_TRUE(AddressList().empty());
+  ASSERT_EQ(expand(AddressList{SPAD_BASE, ACCUM_SPAD_BASE}),
+            (std::vector<addr_type>{SPAD_BASE, ACCUM_SPAD_BASE}));
+}
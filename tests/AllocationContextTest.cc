@@ -0,0 +1,28 @@
+#include <thread>
+
+#include "Common.h"
+#include "gtest/gtest.h"
+
+TEST(AllocationContextTest, BasicAssertions) {
+  /* Simulations on separate threads hand out the same ids and addresses */
+  auto allocate = [](std::vector<uint64_t>* values) {
+    AllocationContext context;
+    bind_allocation_context(&context);
+    for (int i = 0; i < 16; i++) {
+      values->push_back(generate_id());
+      values->push_back(allocate_address(100 * i));
+    }
+    bind_allocation_context(nullptr);
+  };
+  std::vector<uint64_t> first;
+  std::vector<uint64_t> second;
+  std::thread first_thread(allocate, &first);
+  std::thread second_thread(allocate, &second);
+  first_thread.join();
+  second_thread.join();
+
+  ASSERT_EQ(first, second);
+  ASSERT_EQ(first[0], 0);
+  ASSERT_EQ(first[1], 0);
+  ASSERT_EQ(first[2], 1);
+}
@@ -0,0 +1,52 @@
+#include "AnalyticalModel.h"
+#include "gtest/gtest.h"
+
+TEST(AnalyticalModelConvertTest, BasicAssertions) {
+  SimulationConfig config;
+  config.core_height = 8;
+  config.core_width = 8;
+  config.core_freq = 1000;
+  config.icnt_freq = 1000;
+  config.icnt_latency = 1;
+  config.dram_freq = 1000;
+  config.dram_channels = 1;
+  config.dram_req_size = 32;
+  config.dram_latency = 10;
+  config.vector_process_bit = 256;
+
+  std::deque<std::unique_ptr<Tile>> tiles;
+  for (int i = 0; i < 4; i++) {
+    auto tile = std::make_unique<Tile>(Tile{.status = Tile::Status::INITIALIZED,
+                                            .optype = "Conv",
+                                            .layer_id = 7,
+                                            .accum = false,
+                                            .skip = false});
+    std::vector<addr_type> addrs = {0x0, 0x20, 0x40, 0x60};
+    tile->instructions.push_back(std::make_unique<Instruction>(Instruction{
+        .opcode = Opcode::MOVIN, .dest_addr = SPAD_BASE, .size = 4,
+        .src_addrs = AddressList(addrs)}));
+    tile->instructions.push_back(std::make_unique<Instruction>(Instruction{
+        .opcode = Opcode::GEMM_PRELOAD, .dest_addr = ACCUM_SPAD_BASE, .compute_size = 8}));
+    tile->instructions.push_back(std::make_unique<Instruction>(Instruction{
+        .opcode = Opcode::GEMM, .dest_addr = ACCUM_SPAD_BASE, .compute_size = 100}));
+    tiles.push_back(std::move(tile));
+  }
+
+  AnalyticalModel model(config);
+  AnalyticalModel::Estimate estimate = model.convert_tiles(tiles, 2);
+
+  ASSERT_EQ(estimate.tiles, 4);
+  ASSERT_EQ(estimate.read_bytes, 4 * 4 * 32);
+  ASSERT_EQ(estimate.write_bytes, 0);
+  /* Two tiles of one preload and one GEMM per core */
+  ASSERT_EQ(estimate.compute_cycles, 2 * (8 + 100));
+  ASSERT_GE(estimate.cycles, estimate.compute_cycles);
+  ASSERT_EQ(tiles.size(), 2);
+  for (int i = 0; i < 2; i++) {
+    ASSERT_EQ(tiles[i]->layer_id, 7);
+    ASSERT_EQ(tiles[i]->core_id, i);
+    ASSERT_EQ(tiles[i]->analytical_cycles, estimate.cycles);
+    ASSERT_EQ(tiles[i]->analytical_compute_cycles, estimate.compute_cycles);
+    ASSERT_TRUE(tiles[i]->instructions.empty());
+  }
+}
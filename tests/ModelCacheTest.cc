@@ -0,0 +1,90 @@
+#include <filesystem>
+
+#include "ModelCache.h"
+#include "gtest/gtest.h"
+
+TEST(ModelCacheTileRoundTripTest, BasicAssertions) {
+  std::deque<std::unique_ptr<Tile>> tiles;
+  auto tile = std::make_unique<Tile>(Tile{.status = Tile::Status::INITIALIZED,
+                                          .optype = "Conv",
+                                          .layer_id = 10,
+                                          .batch = 1,
+                                          .Q = 2, .P = 3, .M = 4, .C = 5,
+                                          .S = 1, .R = 1,
+                                          .accum = true});
+  std::vector<addr_type> addrs = {0x1000, 0x1020, 0x1040, 0x2000};
+  tile->instructions.push_back(std::make_unique<Instruction>(Instruction{
+      .opcode = Opcode::MOVIN,
+      .id = "inst0",
+      .dependent_ids = {"a", "b"},
+      .dest_addr = SPAD_BASE,
+      .size = 4,
+      .src_addrs = AddressList(addrs)}));
+  tiles.push_back(std::move(tile));
+
+  ModelCache::Writer writer;
+  writer.write_tiles(tiles);
+
+  ModelCache::Relocation relocation{.old_root_id = 1, .new_root_id = 50,
+                                    .old_id_begin = 2, .old_id_end = 20,
+                                    .new_id_begin = 100, .addr_offset = 0x10000};
+  ModelCache::Reader reader(writer.buffer().data(), writer.size());
+  std::deque<std::unique_ptr<Tile>> loaded;
+  reader.read_tiles(loaded, relocation);
+
+  ASSERT_EQ(loaded.size(), 1);
+  ASSERT_EQ(loaded[0]->optype, "Conv");
+  ASSERT_EQ(loaded[0]->layer_id, 108);
+  ASSERT_EQ(loaded[0]->P, 3);
+  ASSERT_TRUE(loaded[0]->accum);
+  ASSERT_EQ(loaded[0]->instructions.size(), 1);
+  auto& inst = loaded[0]->instructions[0];
+  ASSERT_EQ(inst->opcode, Opcode::MOVIN);
+  ASSERT_EQ(inst->dependent_ids, std::vector<std::string>({"a", "b"}));
+  ASSERT_EQ(inst->base_addr, 0x10000);
+  std::vector<addr_type> loaded_addrs;
+  for (addr_type addr : inst->src_addrs)
+    loaded_addrs.push_back(addr);
+  ASSERT_EQ(loaded_addrs, addrs);
+  ASSERT_EQ(reader.position(), writer.buffer().data() + writer.size());
+}
+
+TEST(ModelCacheKeyTest, BasicAssertions) {
+  SimulationConfig config;
+  json model_config = {{"name", "gemm"}, {"batch_size", 1}};
+  uint64_t key = ModelCache::compute_key("gemm.onnx", "gemm.mapping", model_config, config);
+  /* Per-request fields share the compiled model */
+  json request = model_config;
+  request["request_time"] = 0.5;
+  request["partition_id"] = 1;
+  request["slo"] = 3.0;
+  ASSERT_EQ(ModelCache::compute_key("gemm.onnx", "gemm.mapping", request, config), key);
+  json batched = model_config;
+  batched["batch_size"] = 2;
+  ASSERT_NE(ModelCache::compute_key("gemm.onnx", "gemm.mapping", batched, config), key);
+}
+
+TEST(ModelCacheFileTest, BasicAssertions) {
+  std::string path =
+      (std::filesystem::temp_directory_path() / "onnxim_cache_test" / "file.bin").string();
+  {
+    ModelCache::File file(path);
+    ModelCache::Writer header;
+    header.write(ModelCache::MAGIC);
+    header.write(ModelCache::VERSION);
+    header.write<uint64_t>(0);
+    file.append(header.buffer());
+    file.append(std::string("tiles"));
+    file.patch<uint64_t>(sizeof(ModelCache::MAGIC) + sizeof(ModelCache::VERSION), 42);
+    ASSERT_FALSE(std::filesystem::exists(path));
+    ASSERT_TRUE(file.commit());
+  }
+  ModelCache cache(path);
+  ASSERT_TRUE(cache.is_valid());
+  ModelCache::Reader reader(cache.data(), cache.size());
+  reader.read<uint64_t>();
+  reader.read<uint32_t>();
+  ASSERT_EQ(reader.read<uint64_t>(), 42);
+  ASSERT_EQ(std::string(reader.position(), 5), "tiles");
+  std::filesystem::remove_all(std::filesystem::path(path).parent_path());
+}
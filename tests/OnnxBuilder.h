@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cctype>
+#include <string>
+#include <vector>
+
+#include "Common.h"
+
+/*
+ * Helpers building small ONNX graphs in memory, shared by the tests and the
+ * speed benchmark so fixtures need no model files.
+ */
+
+inline void add_input(onnx::GraphProto* graph, std::string name, std::vector<uint32_t> dims) {
+  onnx::ValueInfoProto* input = graph->add_input();
+  input->set_name(name);
+  auto shape = input->mutable_type()->mutable_tensor_type()->mutable_shape();
+  for (uint32_t dim : dims)
+    shape->add_dim()->set_dim_value(dim);
+}
+
+/* Dims that are not numbers stay symbolic (e.g. "batch_size") and are bound by the model config */
+inline void add_symbolic_input(onnx::GraphProto* graph, std::string name,
+                               std::vector<std::string> dims) {
+  onnx::ValueInfoProto* input = graph->add_input();
+  input->set_name(name);
+  auto shape = input->mutable_type()->mutable_tensor_type()->mutable_shape();
+  for (auto& dim : dims) {
+    if (std::isdigit(dim[0]))
+      shape->add_dim()->set_dim_value(std::stoi(dim));
+    else
+      shape->add_dim()->set_dim_param(dim);
+  }
+}
+
+inline void add_initializer(onnx::GraphProto* graph, std::string name,
+                            std::vector<uint32_t> dims) {
+  onnx::TensorProto* tensor = graph->add_initializer();
+  tensor->set_name(name);
+  for (uint32_t dim : dims)
+    tensor->add_dims(dim);
+}
+
+inline onnx::NodeProto* add_node(onnx::GraphProto* graph, std::string op_type, std::string name,
+                                 std::vector<std::string> inputs,
+                                 std::vector<std::string> outputs) {
+  onnx::NodeProto* node = graph->add_node();
+  node->set_op_type(op_type);
+  node->set_name(name);
+  for (auto& input : inputs)
+    node->add_input(input);
+  for (auto& output : outputs)
+    node->add_output(output);
+  return node;
+}
+
+inline void add_int(onnx::NodeProto* node, std::string name, int64_t value) {
+  onnx::AttributeProto* attribute = node->add_attribute();
+  attribute->set_name(name);
+  attribute->set_i(value);
+}
+
+inline void add_ints(onnx::NodeProto* node, std::string name, std::vector<int64_t> values) {
+  onnx::AttributeProto* attribute = node->add_attribute();
+  attribute->set_name(name);
+  for (int64_t value : values)
+    attribute->add_ints(value);
+}
@@ -0,0 +1,449 @@
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "OnnxBuilder.h"
+#include "Serving.h"
+#include "Simulator.h"
+#include "gtest/gtest.h"
+
+static json test_config() {
+  return json{{"num_cores", 2},         {"core_type", "systolic_ws"},
+              {"core_freq", 1000},      {"core_width", 8},
+              {"core_height", 8},       {"spad_size", 64},
+              {"accum_spad_size", 16},  {"sram_width", 32},
+              {"vector_process_bit", 256}, {"add_latency", 1},
+              {"mul_latency", 1},       {"exp_latency", 1},
+              {"gelu_latency", 1},      {"add_tree_latency", 1},
+              {"scalar_sqrt_latency", 1}, {"scalar_add_latency", 1},
+              {"scalar_mul_latency", 1}, {"dram_type", "simple"},
+              {"dram_freq", 1000},      {"dram_channels", 2},
+              {"dram_req_size", 32},    {"dram_latency", 10},
+              {"icnt_type", "simple"},  {"icnt_latency", 1},
+              {"icnt_freq", 1000},      {"precision", 2},
+              {"layout", "NHWC"},       {"scheduler", "simple"}};
+}
+
+/* Gemms of a [32, 64] input and [64, 64] weights, each reading the output of the previous one */
+static std::shared_ptr<const onnx::ModelProto> chain_model(int layers) {
+  auto model_proto = std::make_shared<onnx::ModelProto>();
+  onnx::GraphProto* graph = model_proto->mutable_graph();
+  add_input(graph, "y0", {32, 64});
+  for (int i = 0; i < layers; i++) {
+    std::string index = std::to_string(i);
+    add_initializer(graph, "w" + index, {64, 64});
+    add_node(graph, "Gemm", "Gemm_" + index, {"y" + index, "w" + index},
+             {"y" + std::to_string(i + 1)});
+  }
+  return model_proto;
+}
+
+/* A single Gemm of the chain */
+static std::shared_ptr<const onnx::ModelProto> test_model(std::string node_name = "Gemm_0") {
+  auto model_proto = std::make_shared<onnx::ModelProto>(*chain_model(1));
+  model_proto->mutable_graph()->mutable_node(0)->set_name(node_name);
+  return model_proto;
+}
+
+/* Two independent Gemms reading the same [32, 64] input */
+static std::shared_ptr<const onnx::ModelProto> branch_model() {
+  auto model_proto = std::make_shared<onnx::ModelProto>();
+  onnx::GraphProto* graph = model_proto->mutable_graph();
+  add_input(graph, "x", {32, 64});
+  for (int i = 0; i < 2; i++) {
+    std::string index = std::to_string(i);
+    add_initializer(graph, "w" + index, {64, 64});
+    add_node(graph, "Gemm", "Gemm_" + index, {"x", "w" + index}, {"y" + index});
+  }
+  return model_proto;
+}
+
+static Simulator::Stats simulate(cycle_type step_cycles) {
+  auto simulator = Simulator::create(test_config());
+  simulator->register_model(json{{"name", "gemm"}}, "gemm.onnx", "gemm.mapping", test_model());
+  if (step_cycles == 0) {
+    simulator->run_simulator();
+  } else {
+    while (simulator->step(step_cycles))
+      ;
+  }
+  return simulator->get_stats();
+}
+
+TEST(SimulatorConcurrentTest, BasicAssertions) {
+  Simulator::Stats reference = simulate(0);
+  ASSERT_TRUE(reference.finished);
+  ASSERT_GT(reference.core_cycles, 0);
+  ASSERT_EQ(reference.cores.size(), 2);
+  ASSERT_EQ(reference.layers.size(), 1);
+  ASSERT_EQ(reference.layers[0].name, "Gemm_0");
+
+  /* Simulators on separate threads do not see each other */
+  Simulator::Stats stats[2];
+  std::thread first([&stats]() { stats[0] = simulate(0); });
+  std::thread second([&stats]() { stats[1] = simulate(100); });
+  first.join();
+  second.join();
+  for (auto& result : stats) {
+    ASSERT_TRUE(result.finished);
+    ASSERT_EQ(result.core_cycles, reference.core_cycles);
+    ASSERT_EQ(result.layers[0].finish_cycle, reference.layers[0].finish_cycle);
+  }
+}
+
+TEST(SimulatorStepTest, FastForward) {
+  json config = test_config();
+  config["fast_forward"] = true;
+  auto reference = Simulator::create(config);
+  reference->register_model(json{{"name", "gemm"}}, "gemm.onnx", "gemm.mapping", test_model());
+  reference->run_simulator();
+
+  /* A fast-forward jump never carries step() past its window */
+  auto simulator = Simulator::create(config);
+  simulator->register_model(json{{"name", "gemm"}}, "gemm.onnx", "gemm.mapping", test_model());
+  cycle_type step_cycles = 7;
+  cycle_type last_cycle = 0;
+  bool running = true;
+  while (running) {
+    running = simulator->step(step_cycles);
+    cycle_type core_cycles = simulator->get_stats().core_cycles;
+    ASSERT_LE(core_cycles - last_cycle, step_cycles);
+    last_cycle = core_cycles;
+  }
+  ASSERT_EQ(last_cycle, reference->get_stats().core_cycles);
+}
+
+TEST(SimulatorStatsTest, BasicAssertions) {
+  json config = test_config();
+  std::string path = (std::filesystem::temp_directory_path() / "onnxim_stats_test.json").string();
+  config["stats_path"] = path;
+  config["stats_tiles"] = true;
+  auto simulator = Simulator::create(config);
+  simulator->register_model(json{{"name", "gemm"}}, "gemm.onnx", "gemm.mapping", test_model());
+  simulator->run_simulator();
+
+  Simulator::Stats stats = simulator->get_stats();
+  ASSERT_EQ(stats.models.size(), 1);
+  ASSERT_EQ(stats.models[0].name, "gemm");
+  ASSERT_EQ(stats.models[0].total_cycles,
+            (stats.models[0].finish_time - stats.models[0].request_time) /
+                simulator->get_core_period());
+  ASSERT_EQ(stats.models[0].op_stats.size(), 1);
+  const OpStat& op = stats.models[0].op_stats[0];
+  ASSERT_EQ(op.name, "Gemm_0");
+  ASSERT_EQ(op.op_cycles, op.finish_cycle - op.start_cycle);
+  ASSERT_EQ(op.tile_stats.size(), op.tiles);
+  ASSERT_GT(op.compute_cycles, 0);
+
+  std::ifstream file(path);
+  json written = json::parse(file);
+  ASSERT_EQ(written["core_cycles"], stats.core_cycles);
+  ASSERT_EQ(written["cores"].size(), 2);
+  ASSERT_EQ(written["layers"].size(), 1);
+  ASSERT_EQ(written["tiles"].size(), op.tiles);
+  ASSERT_EQ(written["dram_channels"].size(), 2);
+  uint64_t bytes = 0;
+  for (auto& channel : written["dram_channels"])
+    bytes += channel["read_bytes"].get<uint64_t>() + channel["write_bytes"].get<uint64_t>();
+  ASSERT_GT(bytes, 0);
+  std::filesystem::remove(path);
+}
+
+TEST(SimulatorTraceTest, EscapesNames) {
+  json config = test_config();
+  std::string path = (std::filesystem::temp_directory_path() / "onnxim_trace_test.json").string();
+  config["trace_path"] = path;
+  std::string node_name = "Gemm \"0\"\\\tblock";
+  {
+    auto simulator = Simulator::create(config);
+    simulator->register_model(json{{"name", "gemm"}}, "gemm.onnx", "gemm.mapping",
+                              test_model(node_name));
+    simulator->run_simulator();
+  }
+
+  std::ifstream file(path);
+  json trace = json::parse(file);
+  bool found = false;
+  for (auto& event : trace)
+    found |= event.contains("name") && event["name"] == node_name;
+  ASSERT_TRUE(found);
+  std::filesystem::remove(path);
+}
+
+TEST(SimulatorStatsTest, QuotesCsvFields) {
+  json config = test_config();
+  std::string stem = (std::filesystem::temp_directory_path() / "onnxim_csv_test").string();
+  config["stats_path"] = stem;
+  auto simulator = Simulator::create(config);
+  simulator->register_model(json{{"name", "gemm"}}, "gemm.onnx", "gemm.mapping",
+                            test_model("Gemm \"0\", fused"));
+  simulator->run_simulator();
+
+  std::ifstream file(stem + "_layers.csv");
+  std::string header, row;
+  std::getline(file, header);
+  std::getline(file, row);
+  ASSERT_NE(row.find(",\"Gemm \"\"0\"\", fused\","), std::string::npos);
+  for (std::string suffix : {"_cores", "_models", "_tenants", "_layers", "_dram"})
+    std::filesystem::remove(stem + suffix + ".csv");
+}
+
+static Simulator::Stats simulate_branches(std::string scheduler) {
+  json config = test_config();
+  config["scheduler"] = scheduler;
+  auto simulator = Simulator::create(config);
+  simulator->register_model(json{{"name", "branch"}}, "branch.onnx", "branch.mapping",
+                            branch_model());
+  simulator->run_simulator();
+  return simulator->get_stats();
+}
+
+TEST(LayerParallelSchedulerTest, BasicAssertions) {
+  Simulator::Stats serial = simulate_branches("simple");
+  Simulator::Stats parallel = simulate_branches("layer_parallel");
+  ASSERT_TRUE(parallel.finished);
+  ASSERT_EQ(serial.layers.size(), 2);
+  ASSERT_EQ(parallel.layers.size(), 2);
+  /* The simple scheduler starts the second branch once the first finished */
+  ASSERT_GE(serial.layers[1].start_cycle, serial.layers[0].finish_cycle);
+  /* The second branch fills the cores idling in the first one's tail */
+  ASSERT_LT(parallel.layers[1].start_cycle, parallel.layers[0].finish_cycle);
+  ASSERT_LE(parallel.core_cycles, serial.core_cycles);
+}
+
+/* 3x3 Conv of a [1, 16, 14, 14] input to 128 channels; its tiles differ in length */
+static std::shared_ptr<const onnx::ModelProto> conv_model() {
+  auto model_proto = std::make_shared<onnx::ModelProto>();
+  onnx::GraphProto* graph = model_proto->mutable_graph();
+  add_input(graph, "x", {1, 16, 14, 14});
+  add_initializer(graph, "w", {128, 16, 3, 3});
+  add_initializer(graph, "b", {128});
+  onnx::NodeProto* node = add_node(graph, "Conv", "Conv_0", {"x", "w", "b"}, {"y"});
+  add_ints(node, "kernel_shape", {3, 3});
+  add_ints(node, "strides", {1, 1});
+  add_ints(node, "pads", {1, 1, 1, 1});
+  add_ints(node, "dilations", {1, 1});
+  add_int(node, "group", 1);
+  return model_proto;
+}
+
+TEST(WorkStealingTest, BasicAssertions) {
+  Simulator::Stats stats[2];
+  double imbalance[2];
+  for (bool work_stealing : {false, true}) {
+    json config = test_config();
+    config["num_cores"] = 3;
+    config["work_stealing"] = work_stealing;
+    auto simulator = Simulator::create(config);
+    simulator->register_model(json{{"name", "conv"}}, "conv.onnx", "conv.mapping", conv_model());
+    simulator->run_simulator();
+    stats[work_stealing] = simulator->get_stats();
+    imbalance[work_stealing] = simulator->get_load_imbalance();
+  }
+  ASSERT_TRUE(stats[1].finished);
+  uint64_t stolen_tiles = 0;
+  for (int core_id = 0; core_id < 3; core_id++) {
+    ASSERT_EQ(stats[0].cores[core_id].stolen_tiles, 0);
+    stolen_tiles += stats[1].cores[core_id].stolen_tiles;
+  }
+  /* An idle core takes the unstarted chain of a busy one and finishes the layer sooner */
+  ASSERT_GT(stolen_tiles, 0);
+  ASSERT_EQ(stats[1].models[0].op_stats[0].tiles, stats[0].models[0].op_stats[0].tiles);
+  ASSERT_LT(stats[1].core_cycles, stats[0].core_cycles);
+  ASSERT_LT(imbalance[1], imbalance[0]);
+}
+
+/* A chain of four Gemms, with checkpoints every interval cycles (0: none) or restored from path */
+static Simulator::Stats simulate_checkpoints(cycle_type interval, std::string dir,
+                                             std::string path = "") {
+  json config = test_config();
+  config["checkpoint_interval"] = interval;
+  config["checkpoint_dir"] = dir;
+  auto simulator = Simulator::create(config);
+  simulator->register_model(json{{"name", "chain"}}, "chain.onnx", "chain.mapping",
+                            chain_model(4));
+  if (!path.empty() && !simulator->restore_checkpoint(path))
+    return Simulator::Stats{};
+  simulator->run_simulator();
+  return simulator->get_stats();
+}
+
+TEST(CheckpointTest, BasicAssertions) {
+  std::filesystem::path dir = std::filesystem::temp_directory_path() / "onnxim_checkpoint_test";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  Simulator::Stats plain = simulate_checkpoints(0, dir.string());
+  cycle_type interval = plain.core_cycles / 4;
+  Simulator::Stats checkpointed = simulate_checkpoints(interval, dir.string());
+  std::vector<std::filesystem::path> checkpoints;
+  for (auto& entry : std::filesystem::directory_iterator(dir))
+    checkpoints.push_back(entry.path());
+  ASSERT_FALSE(checkpoints.empty());
+  ASSERT_TRUE(checkpointed.finished);
+  /* Checkpoint files are byte-reproducible */
+  std::filesystem::path repeat_dir = dir / "repeat";
+  std::filesystem::create_directories(repeat_dir);
+  simulate_checkpoints(interval, repeat_dir.string());
+  auto read_file = [](std::filesystem::path path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  };
+  for (auto& path : checkpoints)
+    ASSERT_EQ(read_file(path), read_file(repeat_dir / path.filename()));
+  /* A restored run with the same interval continues the checkpointing run */
+  for (auto& path : checkpoints) {
+    Simulator::Stats restored = simulate_checkpoints(interval, dir.string(), path.string());
+    ASSERT_TRUE(restored.finished);
+    ASSERT_EQ(restored.core_cycles, checkpointed.core_cycles);
+  }
+  std::filesystem::remove_all(dir);
+}
+
+/* A best-effort chain and a two-branch tenant with a latency target arriving during it */
+static std::vector<ModelStat> simulate_tenants(std::string scheduler) {
+  json config = test_config();
+  config["scheduler"] = scheduler;
+  auto simulator = Simulator::create(config);
+  simulator->register_model(json{{"name", "batch"}}, "batch.onnx", "batch.mapping",
+                            chain_model(4));
+  simulator->register_model(json{{"name", "interactive"}, {"request_time", 0.001}, {"slo", 0.003}},
+                            "interactive.onnx", "interactive.mapping", branch_model());
+  simulator->run_simulator();
+  std::vector<ModelStat> models = simulator->get_stats().models;
+  std::sort(models.begin(), models.end(),
+            [](const ModelStat& a, const ModelStat& b) { return a.name < b.name; });
+  return models;
+}
+
+TEST(ThreadPoolTest, MatchesSerialRun) {
+  Simulator::Stats stats[2];
+  for (int threads : {1, 4}) {
+    json config = test_config();
+    config["num_cores"] = 3;
+    config["num_threads"] = threads;
+    auto simulator = Simulator::create(config);
+    simulator->register_model(json{{"name", "conv"}}, "conv.onnx", "conv.mapping", conv_model());
+    simulator->register_model(json{{"name", "chain"}}, "chain.onnx", "chain.mapping",
+                              chain_model(4));
+    simulator->run_simulator();
+    stats[threads > 1] = simulator->get_stats();
+  }
+  ASSERT_TRUE(stats[1].finished);
+  ASSERT_EQ(stats[1].core_cycles, stats[0].core_cycles);
+  for (int core_id = 0; core_id < 3; core_id++) {
+    ASSERT_EQ(stats[1].cores[core_id].compute_cycles, stats[0].cores[core_id].compute_cycles);
+    ASSERT_EQ(stats[1].cores[core_id].memory_stall_cycles,
+              stats[0].cores[core_id].memory_stall_cycles);
+    ASSERT_EQ(stats[1].cores[core_id].idle_cycles, stats[0].cores[core_id].idle_cycles);
+  }
+  ASSERT_EQ(stats[1].layers.size(), stats[0].layers.size());
+  for (size_t i = 0; i < stats[0].layers.size(); i++) {
+    ASSERT_EQ(stats[1].layers[i].name, stats[0].layers[i].name);
+    ASSERT_EQ(stats[1].layers[i].start_cycle, stats[0].layers[i].start_cycle);
+    ASSERT_EQ(stats[1].layers[i].finish_cycle, stats[0].layers[i].finish_cycle);
+  }
+  ASSERT_EQ(stats[1].models.size(), 2);
+  for (size_t i = 0; i < stats[0].models.size(); i++) {
+    ASSERT_EQ(stats[1].models[i].name, stats[0].models[i].name);
+    ASSERT_EQ(stats[1].models[i].finish_cycle, stats[0].models[i].finish_cycle);
+  }
+}
+
+TEST(DeadlineSchedulerTest, BasicAssertions) {
+  std::vector<ModelStat> shared = simulate_tenants("time_multiplex");
+  std::vector<ModelStat> edf = simulate_tenants("edf");
+  ASSERT_EQ(edf.size(), 2);
+  const ModelStat& batch = edf[0];
+  const ModelStat& interactive = edf[1];
+  ASSERT_EQ(batch.slo, 0);
+  ASSERT_EQ(interactive.slo, 3000000);
+  /* Round robin runs a best-effort layer between the two branches */
+  ASSERT_GT(shared[1].finish_time - shared[1].request_time, shared[1].slo);
+  /* The deadline runs both branches first, at the next layer boundary */
+  ASSERT_LE(interactive.finish_time - interactive.request_time, interactive.slo);
+  ASSERT_LT(interactive.finish_time, shared[1].finish_time);
+  ASSERT_GT(batch.finish_time, interactive.finish_time);
+}
+
+TEST(ServingTest, BasicAssertions) {
+  json models_list = {{"models", {{{"name", "gemm"}, {"batch_size", 1}}}}};
+  std::string path = (std::filesystem::temp_directory_path() / "onnxim_serving_test.jsonl").string();
+  std::ofstream(path) << "{\"name\": \"gemm\", \"request_time\": 0.004}\n"
+                      << "\n"
+                      << "{\"name\": \"gemm\", \"request_time\": 0.001, \"batch_size\": 2}\n";
+  std::vector<json> trace = Serving::read_trace(path, models_list);
+  std::filesystem::remove(path);
+  ASSERT_EQ(trace.size(), 2);
+  ASSERT_EQ(trace[0]["batch_size"], 2);
+  ASSERT_EQ(trace[1]["batch_size"], 1);
+
+  std::vector<json> requests = Serving::poisson_trace(models_list, 100000, 8, 1);
+  ASSERT_EQ(requests, Serving::poisson_trace(models_list, 100000, 8, 1));
+  for (size_t i = 1; i < requests.size(); i++)
+    ASSERT_GT(requests[i]["request_time"], requests[i - 1]["request_time"]);
+
+  /* Fast-forward may carry a step past an arrival; latency still counts from the arrival */
+  for (bool fast_forward : {false, true}) {
+    json config = test_config();
+    config["fast_forward"] = fast_forward;
+    auto simulator = Simulator::create(config);
+    Serving serving(simulator.get(), requests, "", {{"gemm", test_model()}});
+    serving.run();
+    Simulator::Stats stats = simulator->get_stats();
+    ASSERT_TRUE(stats.finished);
+    ASSERT_EQ(stats.models.size(), requests.size());
+    /* Requests start on arrival, not when they were registered */
+    for (auto& model : stats.models) {
+      auto it = std::find_if(requests.begin(), requests.end(), [&](const json& request) {
+        return model.request_time ==
+               uint64_t(double(request["request_time"]) * 1000 * 1000 * 1000);
+      });
+      ASSERT_NE(it, requests.end());
+      ASSERT_GE(model.start_time, model.request_time);
+    }
+  }
+}
+
+/* A GPT-2 style Attention of 2 heads over a [batch_size, seq_len, 64] input and its KV cache */
+static std::shared_ptr<const onnx::ModelProto> attention_model() {
+  auto model_proto = std::make_shared<onnx::ModelProto>();
+  onnx::GraphProto* graph = model_proto->mutable_graph();
+  add_symbolic_input(graph, "x", {"batch_size", "seq_len", "64"});
+  add_symbolic_input(graph, "mask", {"batch_size", "total_seq_len"});
+  add_symbolic_input(graph, "past", {"2", "batch_size", "2", "past_seq_len", "32"});
+  add_initializer(graph, "w", {64, 192});
+  add_initializer(graph, "b", {192});
+  onnx::NodeProto* node = add_node(graph, "Attention", "Attention_0",
+                                   {"x", "w", "b", "mask", "past"}, {"y", "present"});
+  add_int(node, "num_heads", 2);
+  return model_proto;
+}
+
+TEST(ContinuousBatchingTest, BasicAssertions) {
+  /* b arrives during the prefill of a, c waits for a free slot */
+  std::vector<json> requests = {
+      {{"name", "llm"}, {"request_time", 0}, {"seq_len", 16}, {"output_len", 4}},
+      {{"name", "llm"}, {"request_time", 1e-6}, {"seq_len", 8}, {"output_len", 2}},
+      {{"name", "llm"}, {"request_time", 2e-6}, {"seq_len", 8}, {"output_len", 1}}};
+  auto simulator = Simulator::create(test_config());
+  ContinuousBatching serving(simulator.get(), requests, "", 2, {{"llm", attention_model()}});
+  serving.run();
+  ASSERT_TRUE(simulator->get_stats().finished);
+  /* Prefill a; decode a + prefill b; decode a, b; decode a + prefill c */
+  ASSERT_EQ(serving.get_iterations(), 4);
+  ASSERT_EQ(simulator->get_stats().models.size(), 6);
+  std::vector<ContinuousBatching::Result> results = serving.get_results();
+  ASSERT_EQ(results.size(), 3);
+  std::sort(results.begin(), results.end(),
+            [](const auto& a, const auto& b) { return a.request_time < b.request_time; });
+  for (size_t i = 0; i < results.size(); i++) {
+    ASSERT_EQ(results[i].tokens, requests[i]["output_len"]);
+    ASSERT_GT(results[i].first_token_time, results[i].request_time);
+    ASSERT_LE(results[i].first_token_time, results[i].finish_time);
+  }
+  /* b joins and leaves the running batch while a decodes */
+  ASSERT_LT(results[1].finish_time, results[0].finish_time);
+  ASSERT_GT(results[1].first_token_time, results[0].first_token_time);
+  ASSERT_GT(results[2].first_token_time, results[1].finish_time);
+  ASSERT_EQ(results[2].finish_time, results[0].finish_time);
+}
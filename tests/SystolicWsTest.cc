@@ -91,4 +91,210 @@ TEST(SystolicWSTwoGemmExecutionTest, BasicAssertions) {
   }
   /* Weight load 7 + Preload 8 + Single mul 8 + Mesh execution 23 + Output delay 1= 47 cycles*/
   ASSERT_EQ(cycle, 47);
-}
\ No newline at end of file
+}
+
+TEST(SystolicWSFastForwardTest, BasicAssertions) {
+  /* Weight statinary config*/
+  SimulationConfig config;
+  config.core_type = CoreType::SYSTOLIC_WS;
+  config.core_height = 8;
+  config.core_width = 8;
+  config.precision = 4;
+  config.dram_req_size = 32;
+  config.spad_size = 192;
+  config.accum_spad_size = 192;
+
+  SystolicWS cores[2] = {SystolicWS(0, config), SystolicWS(1, config)};
+  cycle_type cycles[2] = {0, 0};
+  for (int i = 0; i < 2; i++) {
+    std::unique_ptr<Tile> tile = std::make_unique<Tile>(Tile{
+              .status = Tile::Status::INITIALIZED,
+              .layer_id = 0,
+              .spad_id = 0,
+              .accum_spad_id = 0});
+    for (int j = 0; j < 2; j++) {
+      tile->instructions.push_back(std::make_unique<Instruction>(
+          Instruction{.opcode = Opcode::GEMM_PRELOAD,
+                      .dest_addr = ACCUM_SPAD_BASE,
+                      .compute_size = 8,
+                      .src_addrs = std::vector<addr_type>{}}));
+    }
+    cores[i].issue(std::move(tile));
+  }
+
+  /* Core 1 skips the cycles in which it only waits for its pipeline */
+  while (cores[0].running()) {
+    cores[0].cycle();
+    cycles[0]++;
+    if (cycles[0] > 1000) break;
+  }
+  while (cores[1].running()) {
+    cycle_type next_cycle = cores[1].get_next_event_cycle();
+    if (next_cycle > cycles[1] + 1) {
+      cores[1].fast_forward(next_cycle - cycles[1]);
+      cycles[1] = next_cycle;
+    }
+    cores[1].cycle();
+    cycles[1]++;
+    if (cycles[1] > 1000) break;
+  }
+  ASSERT_EQ(cycles[1], cycles[0]);
+  ASSERT_EQ(cores[1].get_compute_cycles(), cores[0].get_compute_cycles());
+}
+
+TEST(SystolicWSBurstMovinTest, BasicAssertions) {
+  /* Weight statinary config*/
+  SimulationConfig config;
+  config.core_type = CoreType::SYSTOLIC_WS;
+  config.core_height = 8;
+  config.core_width = 8;
+  config.precision = 4;
+  config.dram_req_size = 32;
+  config.dram_burst_length = 4;
+  config.spad_size = 192;
+  config.accum_spad_size = 192;
+
+  SystolicWS core(0, config);
+  std::unique_ptr<Tile> tile = std::make_unique<Tile>(Tile{
+            .status = Tile::Status::INITIALIZED,
+            .layer_id = 0,
+            .spad_id = 0,
+            .accum_spad_id = 0});
+
+  /* Two aligned 4-beat runs and one isolated atom */
+  std::vector<addr_type> src_addrs;
+  for (addr_type addr = 0; addr < 8 * 32; addr += 32)
+    src_addrs.push_back(addr);
+  src_addrs.push_back(512);
+  tile->instructions.push_back(std::make_unique<Instruction>(
+      Instruction{.opcode = Opcode::MOVIN,
+                  .dest_addr = SPAD_BASE,
+                  .size = (uint32_t)src_addrs.size(),
+                  .src_addrs = src_addrs,
+                  .base_addr = 0}));
+
+  core.issue(std::move(tile));
+  cycle_type cycle = 0;
+  std::vector<uint64_t> request_sizes;
+  while (core.running() || core.has_memory_request()) {
+    core.cycle();
+    if (core.has_memory_request()) {
+      MemoryAccess* access = core.top_memory_request();
+      request_sizes.push_back(access->size);
+      access->request = false;
+      core.pop_memory_request();
+      core.push_memory_response(access);
+    }
+    cycle++;
+    if (cycle > 1000) break;
+  }
+  ASSERT_LT(cycle, 1000);
+  ASSERT_EQ(request_sizes, (std::vector<uint64_t>{128, 128, 32}));
+}
+
+TEST(SystolicWSTileMemoTest, BasicAssertions) {
+  /* Weight statinary config*/
+  SimulationConfig config;
+  config.core_type = CoreType::SYSTOLIC_WS;
+  config.core_height = 8;
+  config.core_width = 8;
+  config.precision = 4;
+  config.dram_req_size = 32;
+  config.spad_size = 192;
+  config.accum_spad_size = 192;
+
+  /* Core 1 replays the latency learned from its first three tiles */
+  SimulationConfig memo_config = config;
+  memo_config.tile_memo_threshold = 3;
+  memo_config.tile_memo_validate_interval = 0;
+  SystolicWS cores[2] = {SystolicWS(0, config), SystolicWS(1, memo_config)};
+  cycle_type cycles[2] = {0, 0};
+  uint32_t requests[2] = {0, 0};
+  uint32_t replayed_requests = 0;
+  for (int i = 0; i < 2; i++) {
+    int remaining_tiles = 32;
+    while (remaining_tiles > 0 || cores[i].running() || cores[i].has_memory_request()) {
+      if (remaining_tiles > 0 && cores[i].can_issue(false)) {
+        std::unique_ptr<Tile> tile = std::make_unique<Tile>(Tile{
+                  .status = Tile::Status::INITIALIZED,
+                  .optype = "Gemm",
+                  .layer_id = 0});
+        tile->instructions.push_back(std::make_unique<Instruction>(
+            Instruction{.opcode = Opcode::MOVIN,
+                        .dest_addr = SPAD_BASE,
+                        .size = 4,
+                        .src_addrs = std::vector<addr_type>{0, 32, 64, 96},
+                        .base_addr = 0}));
+        tile->instructions.push_back(std::make_unique<Instruction>(
+            Instruction{.opcode = Opcode::GEMM_PRELOAD,
+                        .dest_addr = ACCUM_SPAD_BASE,
+                        .size = 1,
+                        .compute_size = 8,
+                        .src_addrs = std::vector<addr_type>{SPAD_BASE}}));
+        cores[i].issue(std::move(tile));
+        replayed_requests += cores[i].pop_replayed_accesses().size();
+        remaining_tiles--;
+      }
+      cores[i].cycle();
+      cores[i].pop_finished_tile();
+      if (cores[i].has_memory_request()) {
+        MemoryAccess* access = cores[i].top_memory_request();
+        access->request = false;
+        cores[i].pop_memory_request();
+        cores[i].push_memory_response(access);
+        requests[i]++;
+      }
+      cycles[i]++;
+      if (cycles[i] > 10000) break;
+    }
+  }
+  ASSERT_EQ(requests[0], 32 * 4);
+  /* One cold tile and three warm tiles are simulated in full */
+  ASSERT_EQ(requests[1], 4 * 4);
+  /* The DRAM atoms of replayed tiles are still handed out for the channel statistics */
+  ASSERT_EQ(requests[1] + replayed_requests, 32 * 4);
+  ASSERT_NEAR((double)cycles[1], (double)cycles[0], cycles[0] * 0.1);
+  /* Replayed tiles keep the compute share learned from the full ones */
+  ASSERT_GT(cores[0].get_compute_cycles(), 0);
+  ASSERT_NEAR((double)cores[1].get_compute_cycles(), (double)cores[0].get_compute_cycles(),
+              cores[0].get_compute_cycles() * 0.2);
+}
+
+TEST(SystolicWSCheckpointTest, BasicAssertions) {
+  SimulationConfig config;
+  config.core_type = CoreType::SYSTOLIC_WS;
+  config.core_height = 8;
+  config.core_width = 8;
+  config.precision = 4;
+  config.dram_req_size = 32;
+  config.spad_size = 192;
+  config.accum_spad_size = 192;
+
+  SystolicWS core(0, config);
+  std::unique_ptr<Tile> tile = std::make_unique<Tile>(Tile{
+      .status = Tile::Status::INITIALIZED, .layer_id = 0, .spad_id = 0, .accum_spad_id = 0});
+  tile->instructions.push_back(std::make_unique<Instruction>(
+      Instruction{.opcode = Opcode::GEMM_PRELOAD,
+                  .dest_addr = ACCUM_SPAD_BASE,
+                  .compute_size = 8,
+                  .src_addrs = std::vector<addr_type>{}}));
+  core.issue(std::move(tile));
+  while (core.running())
+    core.cycle();
+  core.pop_finished_tile();
+  ASSERT_TRUE(core.is_idle());
+
+  ModelCache::Writer writer;
+  core.checkpoint(writer);
+  SystolicWS restored(0, config);
+  ModelCache::Reader reader(writer.buffer().data(), writer.size());
+  restored.restore(reader);
+  ASSERT_EQ(reader.position(), writer.buffer().data() + writer.size());
+
+  /* The restored core continues from the same cycle */
+  ASSERT_EQ(restored.get_next_event_cycle(), core.get_next_event_cycle());
+  ASSERT_EQ(restored.get_compute_cycles(), core.get_compute_cycles());
+  ModelCache::Writer restored_writer;
+  restored.checkpoint(restored_writer);
+  ASSERT_EQ(restored_writer.buffer(), writer.buffer());
+}
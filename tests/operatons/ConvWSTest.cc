@@ -14,6 +14,7 @@ namespace fs = std::filesystem;
 
 SimulationConfig get_default_conv_config() {
   SimulationConfig config;
+  config.num_cores = 1;
   config.core_type = CoreType::SYSTOLIC_WS;
   config.core_height = 8;
   config.core_width = 8;
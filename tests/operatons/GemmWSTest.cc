@@ -12,6 +12,7 @@
 
 SimulationConfig get_default_config() {
   SimulationConfig config;
+  config.num_cores = 1;
   config.core_type = CoreType::SYSTOLIC_WS;
   config.core_height = 8;
   config.core_width = 8;